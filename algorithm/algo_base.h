@@ -770,8 +770,8 @@ namespace GHYSTL{
     inline BidirectionalIterator2
     _copy_backward_d(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result,
                      Distance *) {
-        for (Distance distance = last - first; distance > 0; --distance, --result, --last) {
-            *result = *last;
+        for (Distance distance = last - first; distance > 0; --distance) {
+            *--result = *--last;
         }
         return result;
     }
@@ -794,8 +794,8 @@ namespace GHYSTL{
     inline BidirectionalIterator2
     _copy_backward(BidirectionalIterator1 first, BidirectionalIterator1 last, BidirectionalIterator2 result,
                    bidirectional_iterator_tag) {
-        for (; last != first; --last, --result) {
-            *result = *last;
+        while (last != first) {
+            *--result = *--last;
         }
         return result;
     }
@@ -650,7 +650,7 @@ namespace GHYSTL{
 
     template<typename RIter>
     inline void push_heap(RIter first, RIter last){
-        GHYSTL::push_heap(first, last, less<RIter>());
+        GHYSTL::push_heap(first, last, less<iter_val_t<RIter>>());
     }
 
     template<typename RIter, typename Dif, typename value_type, typename Comp>
@@ -669,7 +669,7 @@ namespace GHYSTL{
             right_index = (size_t)(index << 1) + 2;
         }
 
-        if(right_index == len && cmp(val, *first + (--right_index))){//存在左节点，堆是完全二叉树
+        if(right_index == len && cmp(val, *(first + (--right_index)))){//存在左节点，堆是完全二叉树
 	    *(first + index) = std::move(*(first + right_index));
             index = right_index;
         } 
@@ -685,7 +685,7 @@ namespace GHYSTL{
 
     template<typename RIter>
     inline void pop_heap(RIter first, RIter last){
-        GHYSTL::_pop_heap_imple(first, last, less<RIter>());
+        GHYSTL::_pop_heap_imple(first, last, less<iter_val_t<RIter>>());
     }
 
     template<typename RIter, typename Comp>
@@ -695,7 +695,7 @@ namespace GHYSTL{
 
     template<typename RIter>
     inline void sort_heap(RIter first, RIter last){
-        GHYSTL::sort_heap(first, last, less<RIter>());
+        GHYSTL::sort_heap(first, last, less<iter_val_t<RIter>>());
     }
 
     template<typename RIter, typename Comp>
@@ -723,7 +723,7 @@ namespace GHYSTL{
 
     template <typename RIter>
     void make_heap(RIter first, RIter last) { 
-        GHYSTL::make_heap(first, last, less<RIter>());
+        GHYSTL::make_heap(first, last, less<iter_val_t<RIter>>());
     }
 
     // partial_sort
@@ -750,7 +750,7 @@ namespace GHYSTL{
 
     template<typename RIter>
     inline void patial_sort(RIter first, RIter middle, RIter last){
-        GHYSTL::partial_sort(first, middle, last, less<RIter>());
+        GHYSTL::partial_sort(first, middle, last, less<iter_val_t<RIter>>());
     }
 
     // partial_sort_copy
@@ -837,7 +837,7 @@ namespace GHYSTL{
     // 一次快排
     template <typename RIter, typename Comp>
     inline RIter _mid_partition(RIter first, RIter last, const Comp &cmp) {
-        GHYSTL::iter_val_t<RIter> piovt = _get_piovt(*first, *(first + (size_t)(last - first) >> 1),
+        GHYSTL::iter_val_t<RIter> piovt = _get_piovt(*first, *(first + ((size_t)(last - first) >> 1)),
                                                         *(last - 1), cmp);
         for(;;++first){
             for(; cmp(*first, piovt); ++first) ;
@@ -893,7 +893,7 @@ namespace GHYSTL{
 
     template<typename RIter>
     inline void sort(RIter first, RIter last){
-        GHYSTL::sort(first, last, less<RIter>());
+        GHYSTL::sort(first, last, less<iter_val_t<RIter>>());
     }
 
     template<typename RIter, typename value_type, typename Comp>
@@ -925,7 +925,7 @@ namespace GHYSTL{
 
     template<typename RIter, typename value_type>
     inline GHYSTL::pair<RIter, RIter> equal_range(RIter first, RIter last, const value_type& val){
-        return GHYSTL::equal_range(first, last, val, less<RIter>());
+        return GHYSTL::equal_range(first, last, val, less<iter_val_t<RIter>>());
     }
 
     // 使用缓冲区旋转容器
@@ -1084,7 +1084,7 @@ namespace GHYSTL{
     
     template<class RIter>
     inline void nth_element(RIter first, RIter nth, RIter last){
-        GHYSTL::nth_element(first, nth, last, less<RIter>());
+        GHYSTL::nth_element(first, nth, last, less<iter_val_t<RIter>>());
     }
 }
 #endif
@@ -15,15 +15,26 @@
 #define _ALLOC_
 
 #include <cstdlib>
+#include <cstddef>
 #include <cstring>
 #include <new>
 #include <iostream>
+#include <mutex>
+#include <atomic>
 
 #include "../excetdef.h"
 #include "../Iterator/iterator.h"
 
 namespace GHYSTL{
 
+    // 定义 GHYSTL_ALLOC_STATS 之后配置器会记录分配情况，通过 stats() 取得快照
+    // 不定义时统计代码不参与编译，分配和释放的路径上没有任何额外开销
+#ifdef GHYSTL_ALLOC_STATS
+    #define GHYSTL_ALLOC_STAT(expr) expr
+#else
+    #define GHYSTL_ALLOC_STAT(expr)
+#endif
+
     /*-------------------------------------- 第一级配置器-------------------------------------------*/
     // 一级配置器是对堆做处理的，不需要线程控制
     template<int inst>
@@ -42,6 +53,37 @@ namespace GHYSTL{
 
         static void deallocate(void* p, size_t){ std::free(p);};
 
+        // 申请 bytes 字节时实际可用的大小，malloc 按 max_align_t 的边界取整
+        static size_t good_size(size_t bytes){
+            return (bytes + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+        }
+
+        // 批量分配 n 个 bytes 大小的区块，用每个区块开头的指针串成以 nullptr 结尾的链表返回
+        static void* allocate_batch(size_t bytes, size_t n){
+            void* head = nullptr;
+            try{
+                for(; n != 0; --n){
+                    void* p = allocate(bytes);
+                    *static_cast<void**>(p) = head;
+                    head = p;
+                }
+            }
+            catch(...){
+                deallocate_batch(head, bytes);
+                throw;
+            }
+            return head;
+        }
+
+        // 释放 allocate_batch 形式的链表
+        static void deallocate_batch(void* first, size_t){
+            while(first){
+                void* next = *static_cast<void**>(first);
+                std::free(first);
+                first = next;
+            }
+        }
+
         static void* reallocate(void* p, size_t, size_t new_size){
             void* result = std::realloc(p, new_size);
 
@@ -58,19 +100,37 @@ namespace GHYSTL{
             return (old);
         }
 
+        // 走 oom_malloc / oom_realloc 的次数，没有打开统计时恒为 0
+        static size_t oom_count(){
+#ifdef GHYSTL_ALLOC_STATS
+            return oom_calls.load(std::memory_order_relaxed);
+#else
+            return 0;
+#endif
+        }
+
     private:
         static void* oom_malloc(size_t);
         static void* oom_realloc(void*, size_t);
         static void (*malloc_alloc_oom_handler)();
+#ifdef GHYSTL_ALLOC_STATS
+        static std::atomic<size_t> oom_calls;
+#endif
     };
     
     template<int inst>
     void (*malloc_alloc_template<inst>::malloc_alloc_oom_handler)() = nullptr;
 
+#ifdef GHYSTL_ALLOC_STATS
+    template<int inst>
+    std::atomic<size_t> malloc_alloc_template<inst>::oom_calls(0);
+#endif
+
     template<int inst>
     void* malloc_alloc_template<inst>::oom_malloc(size_t n){
         void (*my_malloc_handler)();
         void* result;
+        GHYSTL_ALLOC_STAT(oom_calls.fetch_add(1, std::memory_order_relaxed));
         for(;;){
             my_malloc_handler = malloc_alloc_oom_handler;
             if(my_malloc_handler == nullptr) THROW_BAD_ALLOC;
@@ -84,6 +144,7 @@ namespace GHYSTL{
     void* malloc_alloc_template<inst>::oom_realloc(void* p, size_t n){
         void (*my_malloc_handler)();
         void* result;
+        GHYSTL_ALLOC_STAT(oom_calls.fetch_add(1, std::memory_order_relaxed));
         for(;;){
             my_malloc_handler = malloc_alloc_oom_handler;
             if(my_malloc_handler == nullptr) THROW_BAD_ALLOC;
@@ -96,15 +157,68 @@ namespace GHYSTL{
     // 默认为 0 号 一级配置器
     typedef malloc_alloc_template<0> malloc_alloc;
     
+    // 二级配置器负责的最大区块，超过的交给一级配置器；必须是 128 乘以 2 的幂
+    // 默认 4096 共 _NFREELIST = 16 + 4 * 5 = 36 条自由链表；定义为 128 就是原来的 16 条
+#ifndef GHYSTL_ALLOC_MAX_BYTES
+    #define GHYSTL_ALLOC_MAX_BYTES 4096
+#endif
+
+    // 大小类别的划分：128 字节以内按 8 字节等距划分，
+    // 超过 128 字节后按几何间距划分，每翻一倍分成 _NSTEPS 个类别：
+    // 160、192、224、256、320、384、448、512、640 ... 4096
+    constexpr size_t _alloc_doublings(size_t bytes){
+        return bytes <= 128 ? 0 : 1 + _alloc_doublings(bytes / 2);
+    }
+
     //相当于 宏定义
     enum {_ALIGN = 8}; // 自由链表节点个数的上调边界
-    enum {_MAX_BYTES = 128}; // 自由链表的最大上限
-    enum {_NFREELIST = _MAX_BYTES / _ALIGN}; // 自由链表的个数
-    enum {_NOBJS = 20}; // 每次扩充分配节点个数
+    enum {_SMALL_BYTES = 128}; // 等距划分的上限
+    enum {_NSMALL = _SMALL_BYTES / _ALIGN}; // 等距划分的类别个数
+    enum {_NSTEPS = 4}; // 几何划分时每翻一倍的类别个数
+    enum {_MAX_BYTES = GHYSTL_ALLOC_MAX_BYTES}; // 自由链表的最大上限
+    enum {_NFREELIST = _NSMALL + _NSTEPS * _alloc_doublings(_MAX_BYTES)}; // 自由链表的个数
+    enum {_NOBJS = 20}; // 每次扩充分配节点个数的上限
+    enum {_BATCH_BYTES = _SMALL_BYTES * _NOBJS}; // 一个类别第一次扩充的字节数，大区块的类别因此从较少的节点开始
+    enum {_MAX_BATCH_BYTES = 16 * 1024}; // 一个类别每次扩充的字节数上限
+    enum {_NCACHE_FACTOR = 4}; // 线程缓存中每条自由链表最多保留 _NCACHE_FACTOR 批节点
+    enum {_BULK_BYTES = 256 * 1024}; // allocate_batch 每次从内存池切分的字节数上限
+
+    static_assert(((size_t)_SMALL_BYTES << _alloc_doublings(_MAX_BYTES)) == (size_t)_MAX_BYTES,
+                  "GHYSTL_ALLOC_MAX_BYTES must be 128 times a power of two");
+
+
+    /*---------------------------------------------- 配置器统计快照 ------------------------------------------------*/
+    // 二级配置器的 stats() 返回的快照，各项在取快照时互相之间不保证严格一致
+    struct alloc_stats
+    {
+        bool enabled;                   // 编译时是否定义了 GHYSTL_ALLOC_STATS，为 false 时只有 heap_size、chunk_count、pool_bytes 有效
+        size_t class_bytes[_NFREELIST]; // 每个大小类别的区块大小
+        size_t allocs[_NFREELIST];      // 每个大小类别的分配次数
+        size_t frees[_NFREELIST];       // 每个大小类别的释放次数
+        size_t large_allocs;            // 超过 _MAX_BYTES 转交一级配置器的分配次数
+        size_t large_frees;             // 超过 _MAX_BYTES 转交一级配置器的释放次数
+        size_t refills;                 // 自由链表为空，从内存池切分区块的次数
+        size_t chunk_mallocs;           // 内存池向系统申请大块的次数
+        size_t oom_mallocs;             // 一级配置器走 oom_malloc / oom_realloc 的次数
+        size_t heap_size;               // 内存池向系统申请、目前仍持有的总字节数
+        size_t chunk_count;             // 内存池目前持有的大块个数
+        size_t pool_bytes;              // 内存池中还没有切分的字节数
+        size_t free_list_bytes;         // 挂在自由链表上(含各线程缓存)、没有分配出去的字节数
+        size_t small_bytes;             // 分配给使用者的小区块字节数，按大小类别计
+        size_t large_bytes;             // 分配给使用者的大区块字节数
+        size_t peak_bytes;              // small_bytes + large_bytes 的峰值
+    };
 
 
     /*---------------------------------------------- 第二级空间配置器 ------------------------------------------------*/
     // 二级配置器是要声明线程的开关，因为有自由链表的存在
+    // threads == false: 所有线程共用下面的静态自由链表，不做任何同步
+    // threads == true : 每个线程持有一份 _NFREELIST 条自由链表的缓存，分配和释放的快速路径不加锁；
+    //                   缓存为空时从中心内存池批量取一批区块，缓存过长时批量归还，
+    //                   只有批量搬运时才持有 pool_mutex
+    // 内存池向系统申请的每个大块都串在 chunk_list 上，trim() 会把完全空闲的大块还给系统
+    // 每个类别每次从内存池切分的区块个数从 MIN_OBJS 开始，每次翻倍直到 MAX_OBJS，
+    // 小区块的类别两者都是 _NOBJS，大区块的类别从少量开始，避免很少用到的类别占住大量内存
     template<bool threads, int inst>
     class default_alloc_template
     {
@@ -117,18 +231,90 @@ namespace GHYSTL{
             char client[1]; // 储存本块内存的首地址
         };
 
+        // 内存池向系统申请的大块，头部记录大块的大小，所有大块串成单链表
+        struct chunk_header
+        {
+            chunk_header* next;  // 下一个大块
+            size_t size;         // 头部之后可以切分的字节数
+        };
+
+        // 线程私有的自由链表缓存
+        struct thread_cache
+        {
+            obj* list[_NFREELIST];    // 每个大小类别的自由链表
+            obj* tail[_NFREELIST];    // 自由链表的最后一个节点，归还整条链表时不用再遍历
+            size_t count[_NFREELIST]; // 每条自由链表上的节点个数
+
+            thread_cache(){
+                for(size_t i = 0; i < _NFREELIST; ++i){
+                    list[i] = tail[i] = nullptr;
+                    count[i] = 0;
+                }
+            }
+
+            // 线程退出时把缓存的区块全部还给中心内存池，否则这些区块就丢失了
+            // 析构之后缓存仍然是一个合法的空缓存，静态对象析构时继续使用也不会出错
+            ~thread_cache(){
+                for(size_t i = 0; i < _NFREELIST; ++i){
+                    if(list[i] == nullptr) continue;
+                    release_batch(i, list[i], tail[i], count[i]);
+                    list[i] = tail[i] = nullptr;
+                    count[i] = 0;
+                }
+            }
+        };
+
+        // 中心内存池的锁，单线程版本不加锁
+        class pool_lock
+        {
+        public:
+            pool_lock() { if(threads) pool_mutex.lock(); }
+            ~pool_lock() { if(threads) pool_mutex.unlock(); }
+        };
+
+        static std::mutex pool_mutex;
+
+        static thread_cache& local_cache(){
+            static thread_local thread_cache cache;
+            return cache;
+        }
+
         // volatile: 每次都从内存中取值；编译器不可以（合并、消除）优化；保证volatile变量之间的顺序性
-        // 16个自由链表维护8、16、24、.....128的内存区域 
+        // _NFREELIST 个自由链表：128 以内维护 8、16、24、.....128 的内存区域，往上按几何间距直到 _MAX_BYTES
         static obj* volatile free_list[_NFREELIST];
 
         static char *start_free; // 内存池的起始地址
         static char *end_free;;  // 内存池的结束地址
         static size_t heap_size; // 申请堆空间附加值大小
 
+        static chunk_header* chunk_list; // 向系统申请的所有大块
+        static size_t chunk_count;       // 大块的个数
+        static size_t free_bytes;        // 挂在中心自由链表上的字节数（不含线程缓存）
+        static size_t trim_watermark;    // 自动 trim 的水位线，0 表示关闭
+        static size_t trim_trigger;      // free_bytes 超过这个值时自动 trim
+        static size_t refill_objs[_NFREELIST]; // 每个类别下一次从内存池切分的区块个数，0 表示还没有切分过
+
 
         //根据申请的块的大小，获取 自由链表 编号
         static size_t FREELIST_INDEX(size_t bytes){
-            return ((bytes + _ALIGN - 1)/ _ALIGN - 1);
+            if(bytes <= (size_t)_SMALL_BYTES) return ((bytes + _ALIGN - 1)/ _ALIGN - 1);
+
+            size_t index = _NSMALL;
+            size_t base = _SMALL_BYTES;
+            while(bytes > 2 * base){
+                base <<= 1;
+                index += _NSTEPS;
+            }
+            return index + (bytes - base - 1) / (base / _NSTEPS);
+        }
+
+        // 第 index 条自由链表的区块大小
+        static size_t CLASS_SIZE(size_t index){
+            if(index < (size_t)_NSMALL) return (index + 1) * _ALIGN;
+
+            index -= _NSMALL;
+            const size_t base = (size_t)_SMALL_BYTES << (index / _NSTEPS);
+            return base + (index % _NSTEPS + 1) * (base / _NSTEPS);
         }
 
         // 根据 bytes,上调到8的倍数
@@ -136,20 +322,109 @@ namespace GHYSTL{
             return ((bytes + _ALIGN -1) & ~(_ALIGN - 1));
         }
 
+        // 区块大小为 size 的类别，每次从内存池切分的最少、最多区块个数
+        static size_t MIN_OBJS(size_t size){
+            const size_t n = _BATCH_BYTES / size;
+            return n < 2 ? 2 : (n > (size_t)_NOBJS ? (size_t)_NOBJS : n);
+        }
+
+        static size_t MAX_OBJS(size_t size){
+            const size_t n = _MAX_BATCH_BYTES / size;
+            return n < 2 ? 2 : (n > (size_t)_NOBJS ? (size_t)_NOBJS : n);
+        }
+
+        // 第 index 个类别这一次从内存池切分的区块个数，并把下一次的个数翻倍
+        static size_t next_refill_objs(size_t index){
+            const size_t size = CLASS_SIZE(index);
+            size_t& n = refill_objs[index];
+            if(n == 0) n = MIN_OBJS(size);
+
+            const size_t result = n;
+            if(n < MAX_OBJS(size)) n = (2 * n < MAX_OBJS(size)) ? 2 * n : MAX_OBJS(size);
+            return result;
+        }
+
         // 返回一个大小为n的对象，并可能加入大小为 n 的其他区块到 自由链表中
         static void *refill(size_t bytes);
 
         // 从内存池中取空间给 free list 使用，条件不允许时，会调整 nblock
-        // 配置一大块空间，可容纳 _NOBJS 个大小为size的块
+        // 配置一大块空间，可容纳 nobjs 个大小为size的块
         static char *chunk_alloc(size_t bytes, size_t& nobjs);
+
+        // 从中心内存池的第 index 条自由链表取最多 nobjs 个区块，返回以 nullptr 结尾的链表，
+        // nobjs 改为实际个数，last 指向链表的最后一个节点
+        static obj *fetch_batch(size_t index, size_t& nobjs, obj*& last);
+
+        // 把 [first, last] 这一串共 n 个区块还给中心内存池的第 index 条自由链表
+        static void release_batch(size_t index, obj *first, obj *last, size_t n);
+
+        // 中心自由链表变长之后检查水位线，调用时已经持有 pool_mutex（单线程版本无锁）
+        static void check_watermark(){
+            if(trim_watermark != 0 && free_bytes > trim_trigger) trim_locked();
+        }
+
+        // trim 的实际实现，调用时已经持有 pool_mutex
+        static size_t trim_locked();
+
+        static void *thread_allocate(size_t bytes);
+        static void thread_deallocate(void *ptr, size_t bytes);
+
+        // 从中心内存池取 n 个第 index 类的区块接到链表 head 前面，调用时已经持有 pool_mutex（单线程版本无锁）
+        static obj *central_batch(size_t index, size_t n, obj *head);
+
+#ifdef GHYSTL_ALLOC_STATS
+        // 统计计数器，多线程版本的快速路径不加锁，所以都用原子变量
+        struct counters
+        {
+            std::atomic<size_t> allocs[_NFREELIST];
+            std::atomic<size_t> frees[_NFREELIST];
+            std::atomic<size_t> large_allocs;
+            std::atomic<size_t> large_frees;
+            std::atomic<size_t> refills;
+            std::atomic<size_t> chunk_mallocs;
+            std::atomic<size_t> small_bytes;
+            std::atomic<size_t> large_bytes;
+            std::atomic<size_t> peak_bytes;
+        };
+
+        static counters stat;
+
+        static void stat_alloc(std::atomic<size_t>& bytes_counter, size_t bytes){
+            bytes_counter.fetch_add(bytes, std::memory_order_relaxed);
+            size_t now = stat.small_bytes.load(std::memory_order_relaxed)
+                       + stat.large_bytes.load(std::memory_order_relaxed);
+            size_t peak = stat.peak_bytes.load(std::memory_order_relaxed);
+            while(now > peak && !stat.peak_bytes.compare_exchange_weak(peak, now, std::memory_order_relaxed));
+        }
+#endif
     
     public:
         // 分配大小为 bytes 的空间， n > 0
        static void *allocate(size_t bytes);
         //  释放 p 指向的大小为 bytes 的空间, p 不能为 0
        static void deallocate(void *ptr, size_t bytes);
-        // 重新分配空间，接受三个参数，参数一为指向新空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
+        // 重新分配空间，接受三个参数，参数一为指向原来空间的指针，参数二为原来空间的大小，参数三为申请空间的大小
+        // 保留原来空间的内容（按两者中较小的大小），返回新空间的地址
        static void *reallocate(void *ptr, size_t old_size, size_t new_size);
+        // 一次分配 n 个大小为 bytes 的区块，用每个区块开头的指针串成以 nullptr 结尾的链表返回
+        // 多线程版本先用本线程缓存里的区块，不够的部分只加一次锁从中心内存池取
+       static void *allocate_batch(size_t bytes, size_t n);
+        // 释放 allocate_batch 形式的链表（区块大小都是 bytes），整条链表只做一次归还
+       static void deallocate_batch(void *first, size_t bytes);
+        // 取得配置器当前状态的快照
+       static alloc_stats stats();
+        // 把完全空闲的大块还给系统，返回归还的字节数（不含大块头部）
+        // 多线程版本会先把本线程缓存的区块还给中心内存池，其他线程缓存里的区块所在的大块不会被归还
+       static size_t trim();
+        // 中心自由链表上的空闲字节超过 bytes 时自动 trim，传 0 关闭自动 trim，返回原来的水位线
+       static size_t set_trim_watermark(size_t bytes);
+        // 第 index 条自由链表的区块大小，index < _NFREELIST
+       static size_t class_size(size_t index) { return CLASS_SIZE(index); }
+        // 申请 bytes 字节时实际拿到的区块大小，容器可以把多出来的部分也算进容量
+       static size_t good_size(size_t bytes){
+            if(bytes > (size_t)_MAX_BYTES) return malloc_alloc::good_size(bytes);
+            return CLASS_SIZE(FREELIST_INDEX(bytes ? bytes : 1));
+       }
     };
     
     //参数初始化 和 函数定义
@@ -164,31 +439,66 @@ namespace GHYSTL{
 
     template<bool threads, int inst>
     typename default_alloc_template<threads, inst>::
-    obj* volatile default_alloc_template<threads, inst>::free_list[_NFREELIST] ={
-        nullptr, nullptr, nullptr, nullptr, 
-        nullptr, nullptr, nullptr, nullptr, 
-        nullptr, nullptr, nullptr, nullptr,
-        nullptr, nullptr, nullptr, nullptr
-    };
+    chunk_header* default_alloc_template<threads, inst>::chunk_list = nullptr;
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::chunk_count = 0;
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::free_bytes = 0;
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::trim_watermark = 0;
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::trim_trigger = 0;
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::refill_objs[_NFREELIST] = { 0 };
+
+    template<bool threads, int inst>
+    typename default_alloc_template<threads, inst>::
+    obj* volatile default_alloc_template<threads, inst>::free_list[_NFREELIST] = { nullptr };
+
+    template<bool threads, int inst>
+    std::mutex default_alloc_template<threads, inst>::pool_mutex;
+
+#ifdef GHYSTL_ALLOC_STATS
+    template<bool threads, int inst>
+    typename default_alloc_template<threads, inst>::counters default_alloc_template<threads, inst>::stat;
+#endif
 
     template<bool threads, int inst>
     void* default_alloc_template<threads, inst>::allocate(size_t bytes){
         if(bytes > (size_t)_MAX_BYTES){
-            return (malloc_alloc::allocate(bytes));
+            void* result = malloc_alloc::allocate(bytes);
+            GHYSTL_ALLOC_STAT(stat.large_allocs.fetch_add(1, std::memory_order_relaxed));
+            GHYSTL_ALLOC_STAT(stat_alloc(stat.large_bytes, bytes));
+            return result;
         }
 
+        // 申请 0 字节时按最小的区块分配，和 deallocate 一致，避免 FREELIST_INDEX 下溢越界
+        if(bytes == 0) bytes = _ALIGN;
+
+        GHYSTL_ALLOC_STAT(stat.allocs[FREELIST_INDEX(bytes)].fetch_add(1, std::memory_order_relaxed));
+        GHYSTL_ALLOC_STAT(stat_alloc(stat.small_bytes, CLASS_SIZE(FREELIST_INDEX(bytes))));
+
+        if(threads) return thread_allocate(bytes);
+
         // 选择 自由链表 编号
-        obj* volatile *my_list = free_list + FREELIST_INDEX(bytes);
+        const size_t index = FREELIST_INDEX(bytes);
+        obj* volatile *my_list = free_list + index;
         obj* result = *my_list;
 
         // 没有可用的 自由链表， 重新填充 自由链表
         if(result == nullptr){
-            void *r = refill(ROUND_UP(bytes));
+            void *r = refill(CLASS_SIZE(index));
             return r;
         }
 
         //调整freelist, 将list后面的空间前移，返回list所指的空间
         *my_list = result->free_list_next;
+        free_bytes -= CLASS_SIZE(index);
         return result; // 返回分配的空间的地址
     }
 
@@ -196,31 +506,154 @@ namespace GHYSTL{
     void default_alloc_template<threads, inst>::deallocate(void *ptr, size_t bytes){
         if(bytes > (size_t)_MAX_BYTES){
             malloc_alloc::deallocate(ptr, bytes);
+            GHYSTL_ALLOC_STAT(stat.large_frees.fetch_add(1, std::memory_order_relaxed));
+            GHYSTL_ALLOC_STAT(stat.large_bytes.fetch_sub(bytes, std::memory_order_relaxed));
+            return;
+        }
+
+        // 调用方传入 0 时按最小的区块回收，避免 FREELIST_INDEX 下溢越界
+        if(bytes == 0) bytes = _ALIGN;
+
+        GHYSTL_ALLOC_STAT(stat.frees[FREELIST_INDEX(bytes)].fetch_add(1, std::memory_order_relaxed));
+        GHYSTL_ALLOC_STAT(stat.small_bytes.fetch_sub(CLASS_SIZE(FREELIST_INDEX(bytes)), std::memory_order_relaxed));
+
+        if(threads){
+            thread_deallocate(ptr, bytes);
             return;
         }
 
         obj * node = static_cast<obj*>(ptr);
-        obj* volatile *my_list = free_list + FREELIST_INDEX(bytes);
+        const size_t index = FREELIST_INDEX(bytes);
+        obj* volatile *my_list = free_list + index;
         node->free_list_next = *my_list;
         *my_list = node;
+        free_bytes += CLASS_SIZE(index);
+        check_watermark();
     }
 
     // 重新分配空间
     template<bool threads, int inst>
     void* default_alloc_template<threads, inst>::
     reallocate(void *ptr, size_t old_size, size_t new_size){
+        if(ptr == nullptr) return allocate(new_size);
+
+        // 前后都是大区块，交给 realloc，系统可以原地扩展或者重新映射，不需要整块复制
+        if(old_size > (size_t)_MAX_BYTES && new_size > (size_t)_MAX_BYTES){
+            void* result = malloc_alloc::reallocate(ptr, old_size, new_size);
+            GHYSTL_ALLOC_STAT(stat.large_bytes.fetch_sub(old_size, std::memory_order_relaxed));
+            GHYSTL_ALLOC_STAT(stat_alloc(stat.large_bytes, new_size));
+            return result;
+        }
+
+        // 还在同一个大小类别里，原来的区块就够用
+        if(old_size <= (size_t)_MAX_BYTES && new_size <= (size_t)_MAX_BYTES &&
+           FREELIST_INDEX(old_size ? old_size : 1) == FREELIST_INDEX(new_size ? new_size : 1))
+            return ptr;
+
+        void* result = allocate(new_size);
+        std::memcpy(result, ptr, old_size < new_size ? old_size : new_size);
         deallocate(ptr, old_size);
-        ptr = allocate(new_size);
+        return result;
+    }
+
+    // 多线程版本的分配：先在本线程的缓存里取，缓存为空再批量向中心内存池要
+    template<bool threads, int inst>
+    void* default_alloc_template<threads, inst>::thread_allocate(size_t bytes){
+        thread_cache& cache = local_cache();
+        const size_t index = FREELIST_INDEX(bytes);
+        obj* result = cache.list[index];
+
+        if(result == nullptr){
+            size_t nobjs = MAX_OBJS(CLASS_SIZE(index));
+            result = fetch_batch(index, nobjs, cache.tail[index]);
+            cache.count[index] = nobjs;
+        }
+
+        cache.list[index] = result->free_list_next;
+        if(--cache.count[index] == 0) cache.tail[index] = nullptr;
+        return result;
+    }
+
+    // 多线程版本的释放：放回本线程的缓存，缓存过长时把前一批节点还给中心内存池
+    template<bool threads, int inst>
+    void default_alloc_template<threads, inst>::thread_deallocate(void *ptr, size_t bytes){
+        thread_cache& cache = local_cache();
+        const size_t index = FREELIST_INDEX(bytes);
+        obj* node = static_cast<obj*>(ptr);
+
+        node->free_list_next = cache.list[index];
+        cache.list[index] = node;
+        if(node->free_list_next == nullptr) cache.tail[index] = node;
+
+        const size_t batch = MAX_OBJS(CLASS_SIZE(index));
+        if(++cache.count[index] >= _NCACHE_FACTOR * batch){
+            obj* first = cache.list[index];
+            obj* last = first;
+            for(size_t i = 1; i < batch; ++i) last = last->free_list_next;
 
-        return ptr;
+            cache.list[index] = last->free_list_next;
+            cache.count[index] -= batch;
+            release_batch(index, first, last, batch);
+        }
+    }
+
+    template<bool threads, int inst>
+    typename default_alloc_template<threads, inst>::obj* 
+    default_alloc_template<threads, inst>::fetch_batch(size_t index, size_t& nobjs, obj*& last){
+        pool_lock guard;
+
+        // 中心自由链表上还有节点，最多取走 nobjs 个
+        const size_t bytes = CLASS_SIZE(index);
+        obj* volatile *my_list = free_list + index;
+        obj* result = *my_list;
+        if(result != nullptr){
+            last = result;
+            size_t n = 1;
+            for(; n < nobjs && last->free_list_next != nullptr; ++n)
+                last = last->free_list_next;
+
+            *my_list = last->free_list_next;
+            last->free_list_next = nullptr;
+            nobjs = n;
+            free_bytes -= n * bytes;
+            return result;
+        }
+
+        // 中心自由链表也空了，直接从内存池切出一批区块串起来
+        GHYSTL_ALLOC_STAT(stat.refills.fetch_add(1, std::memory_order_relaxed));
+        const size_t want = next_refill_objs(index);
+        if(want < nobjs) nobjs = want;
+        char* chunk = chunk_alloc(bytes, nobjs);
+        obj* current_obj = (obj*)chunk;
+        for(size_t i = 1; i < nobjs; ++i){
+            obj* next_obj = (obj*)((char*)current_obj + bytes);
+            current_obj->free_list_next = next_obj;
+            current_obj = next_obj;
+        }
+        current_obj->free_list_next = nullptr;
+        last = current_obj;
+
+        return (obj*)chunk;
+    }
+
+    template<bool threads, int inst>
+    void default_alloc_template<threads, inst>::release_batch(size_t index, obj *first, obj *last, size_t n){
+        pool_lock guard;
+
+        obj* volatile *my_list = free_list + index;
+        last->free_list_next = *my_list;
+        *my_list = first;
+        free_bytes += n * CLASS_SIZE(index);
+        check_watermark();
     }
 
     //返回一个大小为n的对象，并且有时候会为适当的freelist增加节点
-    //假设bytes已经上调为8的倍数
+    //假设bytes已经上调为类别大小
     template<bool threads, int inst>
     void * default_alloc_template<threads, inst>::refill(size_t bytes){
         // 记录获得的区块数量
-        size_t nobjs = _NOBJS;
+        size_t nobjs = next_refill_objs(FREELIST_INDEX(bytes));
+        GHYSTL_ALLOC_STAT(stat.refills.fetch_add(1, std::memory_order_relaxed));
 
         // 从内存池中取 nobjs 个区块作为 自由链表 的新节点
         char *chunk = chunk_alloc(bytes, nobjs);
@@ -238,6 +671,7 @@ namespace GHYSTL{
 
         // 剩下的空间分离出来
         *my_list = next_obj = (obj*)(chunk + bytes);
+        free_bytes += (nobjs - 1) * bytes;
 
         for(size_t i=1;;++i){
             current_obj = next_obj;
@@ -252,7 +686,7 @@ namespace GHYSTL{
         return result;
     }
 
-    //内存池(一大块空闲的空间) bytes已经上调为8的倍数
+    //内存池(一大块空闲的空间) bytes已经上调为类别大小
     template <bool threads, int inst>
     char* default_alloc_template<threads, inst>::chunk_alloc(size_t bytes, size_t& nobjs){
         char* result;
@@ -274,42 +708,684 @@ namespace GHYSTL{
             size_t bytes_to_get = 2 * bytes_need + ROUND_UP(heap_size >> 4);
 
             // 如果内存池还有剩余，把剩余的空间加入到 free list 中
-            // 注意此时 bytes_left 小于 bytes， 所以会把剩余的内存池存到 前面的链表中         
-            if(bytes_left > 0){
-                obj* volatile *my_list = free_list + FREELIST_INDEX(bytes_left);
+            // 注意此时 bytes_left 小于 bytes， 所以会把剩余的内存池存到 前面的链表中
+            // 类别大小都是 8 的倍数，剩余空间不一定正好是某个类别，按不超过剩余空间的最大类别逐块切下
+            while(bytes_left >= (size_t)_ALIGN){
+                size_t index = FREELIST_INDEX(bytes_left);
+                if(CLASS_SIZE(index) > bytes_left) --index;
+                const size_t size = CLASS_SIZE(index);
+
+                obj* volatile *my_list = free_list + index;
                 ((obj*)start_free)->free_list_next = *my_list;
                 *my_list = (obj*)start_free;
+                free_bytes += size;
+                start_free += size;
+                bytes_left -= size;
             }
 
-            start_free = (char*)malloc(bytes_to_get);
+            // 大块的头部放在最前面，切分从头部之后开始
+            chunk_header* chunk = (chunk_header*)std::malloc(sizeof(chunk_header) + bytes_to_get);
 
-            if(nullptr == start_free){//堆的内存不足
+            if(nullptr == chunk){//堆的内存不足
                 obj* volatile *my_list, *p;
 
                 // 在自由链表中寻找空间, 且区块足够大的 free list
-               for(size_t i = bytes; i <= _MAX_BYTES; i += _ALIGN){
-                   my_list = free_list + FREELIST_INDEX(i);
+               for(size_t i = FREELIST_INDEX(bytes); i < _NFREELIST; ++i){
+                   my_list = free_list + i;
                    p = *my_list;
                    if(p){
                        *my_list = p->free_list_next;
+                       free_bytes -= CLASS_SIZE(i);
                        start_free = (char*)p;
-                       end_free = start_free + i;
+                       end_free = start_free + CLASS_SIZE(i);
                        return chunk_alloc(bytes, nobjs);
                    }
                }
 
-               end_free = nullptr; //没有内存可用
-               start_free = (char*)malloc_alloc::allocate(bytes_to_get); 
+               start_free = end_free = nullptr; //没有内存可用
+               chunk = (chunk_header*)malloc_alloc::allocate(sizeof(chunk_header) + bytes_to_get); 
             }
 
+            chunk->size = bytes_to_get;
+            chunk->next = chunk_list;
+            chunk_list = chunk;
+            ++chunk_count;
+
             heap_size += bytes_to_get;
+            start_free = (char*)(chunk + 1);
             end_free = start_free + bytes_to_get;
+            GHYSTL_ALLOC_STAT(stat.chunk_mallocs.fetch_add(1, std::memory_order_relaxed));
             return chunk_alloc(bytes, nobjs);
         }
     }
 
+    // 挂在自由链表上的字节数不逐个节点去数，而是用 内存池总量 - 未切分的部分 - 已分配出去的部分 推出来，
+    // 这样取快照不需要遍历链表，也不需要访问其他线程的缓存
+    template<bool threads, int inst>
+    alloc_stats default_alloc_template<threads, inst>::stats(){
+        alloc_stats result;
+        std::memset(&result, 0, sizeof(result));
+
+        {
+            pool_lock guard;
+            result.heap_size = heap_size;
+            result.chunk_count = chunk_count;
+            result.pool_bytes = end_free - start_free;
+        }
+
+        for(size_t i = 0; i < _NFREELIST; ++i) result.class_bytes[i] = CLASS_SIZE(i);
+
+#ifdef GHYSTL_ALLOC_STATS
+        result.enabled = true;
+        for(size_t i = 0; i < _NFREELIST; ++i){
+            result.allocs[i] = stat.allocs[i].load(std::memory_order_relaxed);
+            result.frees[i] = stat.frees[i].load(std::memory_order_relaxed);
+        }
+        result.large_allocs = stat.large_allocs.load(std::memory_order_relaxed);
+        result.large_frees = stat.large_frees.load(std::memory_order_relaxed);
+        result.refills = stat.refills.load(std::memory_order_relaxed);
+        result.chunk_mallocs = stat.chunk_mallocs.load(std::memory_order_relaxed);
+        result.oom_mallocs = malloc_alloc::oom_count();
+        result.small_bytes = stat.small_bytes.load(std::memory_order_relaxed);
+        result.large_bytes = stat.large_bytes.load(std::memory_order_relaxed);
+        result.peak_bytes = stat.peak_bytes.load(std::memory_order_relaxed);
+
+        const size_t carved = result.heap_size - result.pool_bytes;
+        result.free_list_bytes = carved > result.small_bytes ? carved - result.small_bytes : 0;
+#endif
+        return result;
+    }
+
+    template<bool threads, int inst>
+    typename default_alloc_template<threads, inst>::obj*
+    default_alloc_template<threads, inst>::central_batch(size_t index, size_t n, obj *head){
+        const size_t bytes = CLASS_SIZE(index);
+        obj* volatile *my_list = free_list + index;
+
+        // 先用中心自由链表上的区块
+        for(; n != 0 && *my_list != nullptr; --n){
+            obj* p = *my_list;
+            *my_list = p->free_list_next;
+            free_bytes -= bytes;
+            p->free_list_next = head;
+            head = p;
+        }
+
+        // 不够的部分从内存池切分，每次最多 _BULK_BYTES，切出来的区块按地址顺序串好再整段接到前面
+        while(n != 0){
+            size_t nobjs = _BULK_BYTES / bytes;
+            if(nobjs == 0) nobjs = 1;
+            if(nobjs > n) nobjs = n;
+
+            GHYSTL_ALLOC_STAT(stat.refills.fetch_add(1, std::memory_order_relaxed));
+            char* chunk = chunk_alloc(bytes, nobjs);
+            obj* current_obj = (obj*)chunk;
+            for(size_t i = 1; i < nobjs; ++i){
+                obj* next_obj = (obj*)((char*)current_obj + bytes);
+                current_obj->free_list_next = next_obj;
+                current_obj = next_obj;
+            }
+            current_obj->free_list_next = head;
+            head = (obj*)chunk;
+            n -= nobjs;
+        }
+        return head;
+    }
+
+    template<bool threads, int inst>
+    void* default_alloc_template<threads, inst>::allocate_batch(size_t bytes, size_t n){
+        if(n == 0) return nullptr;
+
+        if(bytes > (size_t)_MAX_BYTES){
+            obj* head = nullptr;
+            try{
+                for(; n != 0; --n){
+                    obj* p = (obj*)allocate(bytes);
+                    p->free_list_next = head;
+                    head = p;
+                }
+            }
+            catch(...){
+                deallocate_batch(head, bytes);
+                throw;
+            }
+            return head;
+        }
+
+        if(bytes == 0) bytes = _ALIGN;
+        const size_t index = FREELIST_INDEX(bytes);
+        GHYSTL_ALLOC_STAT(stat.allocs[index].fetch_add(n, std::memory_order_relaxed));
+        GHYSTL_ALLOC_STAT(stat_alloc(stat.small_bytes, n * CLASS_SIZE(index)));
+
+        obj* head = nullptr;
+        if(threads){
+            thread_cache& cache = local_cache();
+            for(; n != 0 && cache.list[index] != nullptr; --n){
+                obj* p = cache.list[index];
+                cache.list[index] = p->free_list_next;
+                --cache.count[index];
+                p->free_list_next = head;
+                head = p;
+            }
+            if(cache.list[index] == nullptr) cache.tail[index] = nullptr;
+            if(n == 0) return head;
+        }
+
+        pool_lock guard;
+        return central_batch(index, n, head);
+    }
+
+    template<bool threads, int inst>
+    void default_alloc_template<threads, inst>::deallocate_batch(void *first, size_t bytes){
+        if(first == nullptr) return;
+
+        if(bytes > (size_t)_MAX_BYTES){
+            for(obj* p = (obj*)first; p; ){
+                obj* next = p->free_list_next;
+                deallocate(p, bytes);
+                p = next;
+            }
+            return;
+        }
+
+        if(bytes == 0) bytes = _ALIGN;
+        const size_t index = FREELIST_INDEX(bytes);
+
+        obj* head = (obj*)first;
+        obj* last = head;
+        size_t n = 1;
+        for(; last->free_list_next; last = last->free_list_next) ++n;
+
+        GHYSTL_ALLOC_STAT(stat.frees[index].fetch_add(n, std::memory_order_relaxed));
+        GHYSTL_ALLOC_STAT(stat.small_bytes.fetch_sub(n * CLASS_SIZE(index), std::memory_order_relaxed));
+
+        if(threads){
+            // 放得进本线程缓存就放缓存，否则整条链表一次还给中心内存池
+            thread_cache& cache = local_cache();
+            if(cache.count[index] + n < _NCACHE_FACTOR * MAX_OBJS(CLASS_SIZE(index))){
+                last->free_list_next = cache.list[index];
+                if(cache.list[index] == nullptr) cache.tail[index] = last;
+                cache.list[index] = head;
+                cache.count[index] += n;
+            }else{
+                last->free_list_next = nullptr;
+                release_batch(index, head, last, n);
+            }
+            return;
+        }
+
+        obj* volatile *my_list = free_list + index;
+        last->free_list_next = *my_list;
+        *my_list = head;
+        free_bytes += n * CLASS_SIZE(index);
+        check_watermark();
+    }
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::trim(){
+        if(threads){
+            // 本线程缓存的区块先还给中心内存池，这样它们所在的大块也有机会被归还
+            thread_cache& cache = local_cache();
+            for(size_t i = 0; i < _NFREELIST; ++i){
+                if(cache.list[i] == nullptr) continue;
+                release_batch(i, cache.list[i], cache.tail[i], cache.count[i]);
+                cache.list[i] = cache.tail[i] = nullptr;
+                cache.count[i] = 0;
+            }
+        }
+
+        pool_lock guard;
+        return trim_locked();
+    }
+
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::set_trim_watermark(size_t bytes){
+        pool_lock guard;
+        size_t old = trim_watermark;
+        trim_watermark = trim_trigger = bytes;
+        return old;
+    }
+
+    // 统计每个大块里空闲的字节数（自由链表上的区块 + 没有切分的内存池），
+    // 空闲字节数等于大块大小的就是完全空闲的大块：先把它里面的区块从自由链表上摘掉，再还给系统
+    template<bool threads, int inst>
+    size_t default_alloc_template<threads, inst>::trim_locked(){
+        const size_t n = chunk_count;
+        if(n == 0) return 0;
+
+        // 大块按地址排序，区块通过二分查找找到所在的大块；内存不够时放弃这次 trim
+        chunk_header** chunks = (chunk_header**)std::malloc(n * sizeof(chunk_header*));
+        size_t* free_in = (size_t*)std::malloc(n * sizeof(size_t));
+        if(chunks == nullptr || free_in == nullptr){
+            std::free(chunks);
+            std::free(free_in);
+            return 0;
+        }
+
+        size_t k = 0;
+        for(chunk_header* c = chunk_list; c; c = c->next) chunks[k++] = c;
+        std::qsort(chunks, n, sizeof(chunk_header*), [](const void* a, const void* b){
+            const char* x = (const char*)*(chunk_header* const*)a;
+            const char* y = (const char*)*(chunk_header* const*)b;
+            return x < y ? -1 : (x > y ? 1 : 0);
+        });
+        for(size_t i = 0; i < n; ++i) free_in[i] = 0;
+
+        // 返回 p 所在大块的下标，不在任何大块里返回 n
+        auto find_chunk = [chunks, n](const char* p) -> size_t {
+            size_t lo = 0, hi = n;
+            while(lo < hi){
+                size_t mid = (lo + hi) / 2;
+                if((const char*)chunks[mid] <= p) lo = mid + 1;
+                else hi = mid;
+            }
+            if(lo == 0) return n;
+            const char* data = (const char*)(chunks[lo - 1] + 1);
+            return (p >= data && p < data + chunks[lo - 1]->size) ? lo - 1 : n;
+        };
+
+        for(size_t i = 0; i < _NFREELIST; ++i){
+            for(obj* p = free_list[i]; p; p = p->free_list_next){
+                size_t c = find_chunk((const char*)p);
+                if(c != n) free_in[c] += CLASS_SIZE(i);
+            }
+        }
+
+        size_t pool_chunk = n;
+        if(end_free != start_free){
+            pool_chunk = find_chunk(start_free);
+            if(pool_chunk != n) free_in[pool_chunk] += end_free - start_free;
+        }
+
+        // free_in 改为标记：1 表示这个大块可以归还
+        size_t nfree = 0;
+        for(size_t i = 0; i < n; ++i){
+            free_in[i] = (free_in[i] == chunks[i]->size) ? 1 : 0;
+            nfree += free_in[i];
+        }
+
+        size_t released = 0;
+        if(nfree != 0){
+            // 从中心自由链表上摘掉属于待归还大块的区块
+            for(size_t i = 0; i < _NFREELIST; ++i){
+                obj* volatile *link = free_list + i;
+                while(*link){
+                    obj* p = *link;
+                    size_t c = find_chunk((const char*)p);
+                    if(c != n && free_in[c]){
+                        *link = p->free_list_next;
+                        free_bytes -= CLASS_SIZE(i);
+                    }else{
+                        link = &p->free_list_next;
+                    }
+                }
+            }
+
+            if(pool_chunk != n && free_in[pool_chunk]) start_free = end_free = nullptr;
+
+            // 从 chunk_list 上摘掉并归还
+            for(chunk_header** link = &chunk_list; *link; ){
+                chunk_header* c = *link;
+                if(free_in[find_chunk((const char*)(c + 1))]){
+                    *link = c->next;
+                    released += c->size;
+                    heap_size -= c->size;
+                    --chunk_count;
+                    std::free(c);
+                }else{
+                    link = &c->next;
+                }
+            }
+        }
+
+        std::free(chunks);
+        std::free(free_in);
+
+        // 碎片化严重时 trim 之后可能仍在水位线之上，把下一次触发点往后推，避免每次释放都 trim
+        if(trim_watermark != 0)
+            trim_trigger = free_bytes > trim_watermark ? free_bytes + trim_watermark : trim_watermark;
+        return released;
+    }
+
     // 默认为 0 号 二级配置器，多线程开启
     typedef default_alloc_template<true, 0> default_alloc;
 
+
+    /*---------------------------------------------- 按指定边界对齐的分配 ------------------------------------------------*/
+    // 两级配置器只保证 _ALIGN(8 字节) 对齐，alignas(32)、alignas(64) 之类的类型要单独处理
+    // 多申请 align 个字节，把返回地址向上对齐，原始地址存在返回地址前面的一个指针里
+    // align 必须是 2 的幂，并且大于 _ALIGN
+    template<typename Alloc>
+    class aligned_alloc_template
+    {
+    public:
+        static void* allocate(size_t bytes, size_t align){
+            char* raw = (char*)Alloc::allocate(bytes + align);
+            char* result = (char*)(((size_t)raw + sizeof(void*) + align - 1) & ~(align - 1));
+            ((void**)result)[-1] = raw;
+            return result;
+        }
+
+        static void deallocate(void* p, size_t bytes, size_t align){
+            Alloc::deallocate(((void**)p)[-1], bytes + align);
+        }
+    };
+
+
+    /*---------------------------------------------- 单调内存池(arena) ------------------------------------------------*/
+    // 在大块内存上移动指针来分配空间，单个区块的释放直接忽略，空间只能整体回收
+    // reset()   把指针移回第一个大块，已经申请的大块留下来复用，O(1)
+    // release() 把所有大块还给系统
+    // 和上面两级配置器不同，arena 是一个对象，不是静态的，不同的 arena 之间互不影响，也不做线程同步
+    class monotonic_arena
+    {
+    private:
+        // 每个大块的头部，大块之间按申请顺序串成单链表
+        struct chunk_header
+        {
+            chunk_header* next;  // 下一个大块
+            size_t size;         // 可用空间的字节数，不含头部
+        };
+
+        enum {_ARENA_ALIGN = alignof(std::max_align_t)}; // 分配出去的区块的对齐边界
+        enum {_ARENA_INIT_CHUNK = 4096}; // 第一个大块的默认大小
+        enum {_ARENA_MAX_CHUNK = 1 << 20}; // 大块每次翻倍，最大不超过 1MB（超大的请求单独占一个大块）
+
+        chunk_header* head;         // 第一个大块
+        chunk_header* current;      // 正在切分的大块
+        char* start_free;           // 当前大块的空闲起始地址
+        char* end_free;             // 当前大块的结束地址
+        size_t next_chunk_size;     // 下一次向系统申请的大块大小
+        size_t chunk_bytes;         // 所有大块的总字节数
+
+        static size_t ROUND_UP(size_t bytes){
+            return ((bytes + _ARENA_ALIGN - 1) & ~(size_t)(_ARENA_ALIGN - 1));
+        }
+
+        static char* chunk_data(chunk_header* chunk){
+            return (char*)chunk + ROUND_UP(sizeof(chunk_header));
+        }
+
+        void use_chunk(chunk_header* chunk){
+            current = chunk;
+            start_free = chunk_data(chunk);
+            end_free = start_free + chunk->size;
+        }
+
+        // 当前大块不够用：先往后找已经申请过的大块，都不够再向系统申请新的大块
+        void* allocate_slow(size_t bytes);
+
+    public:
+        explicit monotonic_arena(size_t initial_size = _ARENA_INIT_CHUNK)
+            : head(nullptr), current(nullptr), start_free(nullptr), end_free(nullptr),
+              next_chunk_size(ROUND_UP(initial_size ? initial_size : (size_t)_ARENA_INIT_CHUNK)), chunk_bytes(0) {}
+
+        monotonic_arena(const monotonic_arena&) = delete;
+        monotonic_arena& operator=(const monotonic_arena&) = delete;
+
+        ~monotonic_arena() { release(); }
+
+        void* allocate(size_t bytes){
+            bytes = ROUND_UP(bytes ? bytes : 1);
+            if(bytes <= static_cast<size_t>(end_free - start_free)){
+                void* result = start_free;
+                start_free += bytes;
+                return result;
+            }
+            return allocate_slow(bytes);
+        }
+
+        // 按 align 对齐分配，align 必须是 2 的幂
+        void* allocate(size_t bytes, size_t align){
+            if(align <= (size_t)_ARENA_ALIGN) return allocate(bytes);
+
+            bytes = ROUND_UP(bytes ? bytes : 1);
+            char* result = (char*)(((size_t)start_free + align - 1) & ~(align - 1));
+            if(start_free && result <= end_free && bytes <= static_cast<size_t>(end_free - result)){
+                start_free = result + bytes;
+                return result;
+            }
+            // 当前大块放不下，多申请 align 个字节留给对齐
+            result = (char*)allocate_slow(bytes + align);
+            return (char*)(((size_t)result + align - 1) & ~(align - 1));
+        }
+
+        // 单个区块不回收
+        void deallocate(void*, size_t) noexcept {}
+
+        // 申请 bytes 字节时实际占用的大小
+        static size_t good_size(size_t bytes){
+            return ROUND_UP(bytes ? bytes : 1);
+        }
+
+        // 一次切出 n 个 bytes 大小的区块，用区块开头的指针串成以 nullptr 结尾的链表
+        // bytes 是 align 的整数倍时，每个区块都按 align 对齐
+        void* allocate_batch(size_t bytes, size_t n, size_t align = _ARENA_ALIGN){
+            if(n == 0) return nullptr;
+            bytes = ROUND_UP(bytes ? bytes : 1);
+            char* block = (char*)allocate(bytes * n, align);
+            for(size_t i = 0; i + 1 < n; ++i)
+                *(void**)(block + i * bytes) = block + (i + 1) * bytes;
+            *(void**)(block + (n - 1) * bytes) = nullptr;
+            return block;
+        }
+
+        void deallocate_batch(void*, size_t) noexcept {}
+
+        // ptr 是最近一次分配的区块并且当前大块还放得下时原地扩展，否则重新分配并复制原来的内容
+        void* reallocate(void* ptr, size_t old_size, size_t new_size, size_t align = _ARENA_ALIGN){
+            if(ptr == nullptr) return allocate(new_size, align);
+
+            old_size = ROUND_UP(old_size ? old_size : 1);
+            new_size = ROUND_UP(new_size ? new_size : 1);
+            if(new_size <= old_size) return ptr;
+            if((char*)ptr + old_size == start_free && new_size - old_size <= static_cast<size_t>(end_free - start_free)){
+                start_free += new_size - old_size;
+                return ptr;
+            }
+
+            void* result = allocate(new_size, align);
+            std::memcpy(result, ptr, old_size);
+            return result;
+        }
+
+        // 之前分配出去的空间全部作废，大块留着复用
+        void reset() noexcept {
+            if(head) use_chunk(head);
+        }
+
+        // 所有大块还给系统
+        void release() noexcept {
+            for(chunk_header* chunk = head; chunk; ){
+                chunk_header* next = chunk->next;
+                malloc_alloc::deallocate(chunk, ROUND_UP(sizeof(chunk_header)) + chunk->size);
+                chunk = next;
+            }
+            head = current = nullptr;
+            start_free = end_free = nullptr;
+            chunk_bytes = 0;
+        }
+
+        // 向系统申请的总字节数
+        size_t capacity() const noexcept { return chunk_bytes; }
+    };
+
+    inline void* monotonic_arena::allocate_slow(size_t bytes){
+        // reset 之后，后面还有申请过的大块，直接复用
+        while(current && current->next){
+            use_chunk(current->next);
+            if(bytes <= current->size){
+                void* result = start_free;
+                start_free += bytes;
+                return result;
+            }
+        }
+
+        const size_t size = bytes > next_chunk_size ? bytes : next_chunk_size;
+        chunk_header* chunk = (chunk_header*)malloc_alloc::allocate(ROUND_UP(sizeof(chunk_header)) + size);
+        chunk->size = size;
+        chunk->next = nullptr;
+        chunk_bytes += size;
+
+        if(current) current->next = chunk;
+        else head = chunk;
+        use_chunk(chunk);
+
+        if(next_chunk_size < (size_t)_ARENA_MAX_CHUNK) next_chunk_size <<= 1;
+
+        void* result = start_free;
+        start_free += bytes;
+        return result;
+    }
+
+
+    /*---------------------------------------------- 按类型划分的结点池(slab) ------------------------------------------------*/
+    // node_pool<T>::stats() 返回的快照
+    struct node_pool_stats
+    {
+        size_t slot_size;       // 每个槽位的字节数
+        size_t slots_per_page;  // 每页切成的槽位个数
+        size_t pages;           // 向系统申请的页数，页不归还
+        size_t capacity;        // 所有页的槽位总数
+        size_t in_use;          // 正在使用的槽位
+        size_t peak_in_use;     // 使用槽位的峰值
+        size_t allocs;          // 累计分配次数
+        size_t frees;           // 累计释放次数
+    };
+
+    // 每个类型 T 单独一个池：整页向系统申请，按 T 的大小切成槽位，空闲槽位用开头的指针串成自由链表
+    // 同一种结点挨在一起，不再和其他同样大小的分配混在二级配置器的同一条自由链表里
+    // 只负责单个 T 的分配，数组仍然交给二级配置器
+    template<typename T>
+    class node_pool
+    {
+    public:
+        enum {slot_align = alignof(T) > (size_t)_ALIGN ? alignof(T) : (size_t)_ALIGN}; // 槽位的对齐边界
+        enum {slot_size = (sizeof(T) + slot_align - 1) & ~(slot_align - 1)}; // 槽位大小，至少放得下一个指针
+        enum {_PAGE_BYTES = 4096}; // 一页的字节数
+        enum {_MIN_SLOTS = 8}; // 大类型每页至少切成的槽位个数
+        enum {slots_per_page = slot_size * _MIN_SLOTS > _PAGE_BYTES ? _MIN_SLOTS : _PAGE_BYTES / slot_size};
+
+        static void* allocate(){
+            std::lock_guard<std::mutex> guard(pool_mutex());
+            if(free_list == nullptr) refill();
+            void* result = free_list;
+            free_list = *(void**)result;
+            count_alloc(1);
+            return result;
+        }
+
+        static void deallocate(void* p){
+            if(p == nullptr) return;
+            std::lock_guard<std::mutex> guard(pool_mutex());
+            *(void**)p = free_list;
+            free_list = p;
+            --in_use;
+            ++frees;
+        }
+
+        // 一次取 n 个槽位，按在页里的顺序串成以 nullptr 结尾的链表
+        static void* allocate_batch(size_t n){
+            void* head = nullptr;
+            void** tail = &head;
+            std::lock_guard<std::mutex> guard(pool_mutex());
+            try{
+                for(size_t i = 0; i != n; ++i){
+                    if(free_list == nullptr) refill();
+                    *tail = free_list;
+                    tail = (void**)free_list;
+                    free_list = *(void**)free_list;
+                }
+            }
+            catch(...){
+                // 已经取下来的槽位接回自由链表
+                *tail = free_list;
+                free_list = head;
+                throw;
+            }
+            *tail = nullptr;
+            count_alloc(n);
+            return head;
+        }
+
+        // 整串槽位一次接回自由链表
+        static void deallocate_batch(void* first){
+            if(first == nullptr) return;
+            size_t n = 1;
+            void* last = first;
+            for(; *(void**)last; last = *(void**)last) ++n;
+
+            std::lock_guard<std::mutex> guard(pool_mutex());
+            *(void**)last = free_list;
+            free_list = first;
+            in_use -= n;
+            frees += n;
+        }
+
+        static node_pool_stats stats(){
+            std::lock_guard<std::mutex> guard(pool_mutex());
+            node_pool_stats st;
+            st.slot_size = slot_size;
+            st.slots_per_page = slots_per_page;
+            st.pages = pages;
+            st.capacity = pages * slots_per_page;
+            st.in_use = in_use;
+            st.peak_in_use = peak_in_use;
+            st.allocs = allocs;
+            st.frees = frees;
+            return st;
+        }
+
+    private:
+        static std::mutex& pool_mutex(){
+            static std::mutex m;
+            return m;
+        }
+
+        static void count_alloc(size_t n){
+            in_use += n;
+            allocs += n;
+            if(in_use > peak_in_use) peak_in_use = in_use;
+        }
+
+        // 自由链表空了，申请一页，槽位按地址顺序串起来
+        static void refill(){
+            const size_t bytes = (size_t)slot_size * slots_per_page;
+            char* page = slot_align > alignof(std::max_align_t)
+                            ? (char*)aligned_alloc_template<malloc_alloc>::allocate(bytes, slot_align)
+                            : (char*)malloc_alloc::allocate(bytes);
+            for(size_t i = 0; i + 1 < (size_t)slots_per_page; ++i)
+                *(void**)(page + i * slot_size) = page + (i + 1) * slot_size;
+            *(void**)(page + (slots_per_page - 1) * slot_size) = nullptr;
+            free_list = page;
+            ++pages;
+        }
+
+        static void* free_list;
+        static size_t pages;
+        static size_t in_use;
+        static size_t peak_in_use;
+        static size_t allocs;
+        static size_t frees;
+    };
+
+    template<typename T>
+    void* node_pool<T>::free_list = nullptr;
+
+    template<typename T>
+    size_t node_pool<T>::pages = 0;
+
+    template<typename T>
+    size_t node_pool<T>::in_use = 0;
+
+    template<typename T>
+    size_t node_pool<T>::peak_in_use = 0;
+
+    template<typename T>
+    size_t node_pool<T>::allocs = 0;
+
+    template<typename T>
+    size_t node_pool<T>::frees = 0;
+
 }// end of namesapce
 #endif
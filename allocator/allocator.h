@@ -13,11 +13,29 @@
 #ifndef GHYSTL_ALLOCATOR_H_
 #define GHYSTL_ALLOCATOR_H_
 
+#include <type_traits>
+
 #include "alloc.h"
 #include "../util/util.h"
 
 namespace GHYSTL{
-    template<class value_type_, class Alloc>
+
+    // 可以直接按字节搬到新地址的类型，扩容时可以用 reallocate 整块搬动，不需要逐个构造、析构
+    // 默认是 trivially copyable 的类型，其他满足条件的类型可以特化这个模板
+    template<typename value_type>
+    struct is_trivially_relocatable : bool_type<std::is_trivially_copyable<value_type>::value> {};
+
+    // 判断分配器有没有 reallocate(ptr, old_n, new_n)
+    template<typename Alloc, typename = void>
+    struct has_reallocate : false_type {};
+
+    template<typename Alloc>
+    struct has_reallocate<Alloc, decltype((void)std::declval<Alloc&>().reallocate(
+                                    std::declval<typename Alloc::pointer>(), size_t(), size_t()))> : true_type {};
+
+    // Align 是额外要求的对齐边界，实际的对齐边界取 Align 和 alignof(value_type) 中大的那个
+    // 对齐边界超过配置器保证的 _ALIGN 时，allocate/deallocate 转到 aligned_alloc_template
+    template<class value_type_, class Alloc, size_t Align = alignof(value_type_)>
     class allocator_base{
     public:
         typedef value_type_                 value_type;
@@ -29,23 +47,61 @@ namespace GHYSTL{
         typedef ptrdiff_t                   difference_type;
         typedef Alloc                       alloc;
 
+        static_assert((Align & (Align - 1)) == 0, "alignment must be a power of two");
+
+        enum{
+            alignment = Align > alignof(value_type) ? Align : alignof(value_type),
+            over_aligned = alignment > _ALIGN // 配置器给的空间不够对齐
+        };
+
         /*----------------------------------------------------- 空间分配和销毁 ---------------------------------------------------*/        
 
         inline static pointer allocate(){
-            return static_cast<pointer>(alloc::allocate(sizeof(value_type)));
+            return allocate_bytes(sizeof(value_type), bool_type<over_aligned>());
         }
 
         // 分配 n 个变量的内存，不是 n 个字节
         inline static pointer allocate(const size_type n){
-            return (n ? static_cast<pointer>(alloc::allocate(sizeof(value_type) * n)) : nullptr);
+            return (n ? allocate_bytes(sizeof(value_type) * n, bool_type<over_aligned>()) : nullptr);
         }
 
         inline static void deallocate(pointer ptr){
-            if(ptr) alloc::deallocate(ptr, sizeof(value_type) * 1);
+            if(ptr) deallocate_bytes(ptr, sizeof(value_type) * 1, bool_type<over_aligned>());
         }
 
         inline static void deallocate(pointer ptr, size_type n){
-            if(ptr) alloc::deallocate(ptr, sizeof(value_type) * n);
+            if(ptr) deallocate_bytes(ptr, sizeof(value_type) * n, bool_type<over_aligned>());
+        }
+
+        // 一次分配 n 个变量的空间，每个变量是单独的一块，用每块空间开头的指针串成以 nullptr 结尾的单链表返回
+        // 用 batch_next 沿链表往下走；容器一次创建很多节点时用它，整批只访问一次内存池
+        inline static pointer allocate_batch(size_type n){
+            static_assert(sizeof(value_type) >= sizeof(void*), "allocate_batch needs room for a link in each block");
+            return allocate_batch_imple(n, bool_type<over_aligned>());
+        }
+
+        // 释放用 batch_next 串起来的一串空间
+        inline static void deallocate_batch(pointer first){
+            deallocate_batch_imple(first, bool_type<over_aligned>());
+        }
+
+        // 把 old_n 个变量的空间调整为 new_n 个，保留原来的内容，返回新空间
+        // 内容是按字节搬过去的，所以只能用于 is_trivially_relocatable 的类型
+        inline static pointer reallocate(pointer ptr, size_type old_n, size_type new_n){
+            static_assert(is_trivially_relocatable<value_type>::value,
+                          "reallocate requires a trivially relocatable value_type");
+            if(ptr == nullptr || old_n == 0) return allocate(new_n);
+            if(new_n == 0){
+                deallocate(ptr, old_n);
+                return nullptr;
+            }
+            return reallocate_imple(ptr, old_n, new_n, bool_type<over_aligned>());
+        }
+
+        // 申请 n 个变量时，配置器实际给的空间能放下多少个
+        inline static size_type good_size(size_type n){
+            if(over_aligned || n == 0) return n;
+            return alloc::good_size(sizeof(value_type) * n) / sizeof(value_type);
         }
 
         // 最多可以存储多少个 该类型
@@ -81,6 +137,11 @@ namespace GHYSTL{
             return (first);
         }
 
+        // 默认初始化(不带括号的 new)：int、char 这类类型不清零，值是不确定的
+        inline static pointer default_construct(pointer first, pointer last){
+            return default_construct_imple(first, last, bool_type<std::is_trivially_default_constructible<value_type>::value>());
+        }
+
         // 复制构造函数
         template<typename type>
         inline static void copy_construct(type* ptr, const type& val){
@@ -140,8 +201,80 @@ namespace GHYSTL{
         }
 
     private:    
+        /*-------------------------------------------------------按对齐边界分配---------------------------------------------------------------------*/
+
+        inline static pointer allocate_bytes(size_type bytes, GHYSTL::false_type){
+            return static_cast<pointer>(alloc::allocate(bytes));
+        }
+
+        inline static pointer allocate_bytes(size_type bytes, GHYSTL::true_type){
+            return static_cast<pointer>(aligned_alloc_template<alloc>::allocate(bytes, alignment));
+        }
+
+        inline static void deallocate_bytes(pointer ptr, size_type bytes, GHYSTL::false_type){
+            alloc::deallocate(ptr, bytes);
+        }
+
+        inline static void deallocate_bytes(pointer ptr, size_type bytes, GHYSTL::true_type){
+            aligned_alloc_template<alloc>::deallocate(ptr, bytes, alignment);
+        }
+
+        inline static pointer allocate_batch_imple(size_type n, GHYSTL::false_type){
+            return static_cast<pointer>(alloc::allocate_batch(sizeof(value_type), n));
+        }
+
+        // 内存池切出来的区块不满足对齐要求，逐个分配再串起来
+        inline static pointer allocate_batch_imple(size_type n, GHYSTL::true_type){
+            pointer head = nullptr;
+            try{
+                for(; n != 0; --n){
+                    pointer p = allocate();
+                    *reinterpret_cast<pointer*>(p) = head;
+                    head = p;
+                }
+            }
+            catch(...){
+                deallocate_batch_imple(head, GHYSTL::true_type());
+                throw;
+            }
+            return head;
+        }
+
+        inline static void deallocate_batch_imple(pointer first, GHYSTL::false_type){
+            alloc::deallocate_batch(first, sizeof(value_type));
+        }
+
+        inline static void deallocate_batch_imple(pointer first, GHYSTL::true_type){
+            while(first){
+                pointer next = *reinterpret_cast<pointer*>(first);
+                deallocate(first);
+                first = next;
+            }
+        }
+
+        inline static pointer reallocate_imple(pointer ptr, size_type old_n, size_type new_n, GHYSTL::false_type){
+            return static_cast<pointer>(alloc::reallocate(ptr, sizeof(value_type) * old_n, sizeof(value_type) * new_n));
+        }
+
+        // 配置器的 reallocate 不保证对齐，重新分配后按字节复制
+        inline static pointer reallocate_imple(pointer ptr, size_type old_n, size_type new_n, GHYSTL::true_type){
+            pointer result = allocate(new_n);
+            std::memcpy(result, ptr, sizeof(value_type) * (old_n < new_n ? old_n : new_n));
+            deallocate(ptr, old_n);
+            return result;
+        }
+
         /*-------------------------------------------------------基本的构造函数---------------------------------------------------------------------*/
 
+        inline static pointer default_construct_imple(pointer, pointer last, GHYSTL::true_type){
+            return last;
+        }
+
+        inline static pointer default_construct_imple(pointer first, pointer last, GHYSTL::false_type){
+            for(; first != last; ++first) new(first) value_type;
+            return first;
+        }
+
         inline static void copy_construct_imple(pointer ptr, const value_type& val, GHYSTL::true_type){
             *ptr = val;
         }
@@ -283,8 +416,21 @@ namespace GHYSTL{
         {
             typedef allocator<value_type> other;
         }; 
+
+        allocator() noexcept {}
+
+        // rebind 之后的分配器可以由原分配器构造，容器用它生成节点的分配器
+        template<typename other_type>
+        allocator(const allocator<other_type>&) noexcept {}
     };
 
+    // 无状态的分配器，任意两个实例都可以互相释放对方分配的空间
+    template<typename T1, typename T2>
+    inline bool operator==(const allocator<T1>&, const allocator<T2>&) noexcept { return true; }
+
+    template<typename T1, typename T2>
+    inline bool operator!=(const allocator<T1>&, const allocator<T2>&) noexcept { return false; }
+
 
     template<typename value_type_>
     class simple_allocator 
@@ -292,8 +438,8 @@ namespace GHYSTL{
 
     {
     public:
-        typedef allocator_base<value_type_, default_alloc>               base_type;
-        typedef typename base_type::value_typ                            value_type;
+        typedef allocator_base<value_type_, malloc_alloc>                base_type;
+        typedef typename base_type::value_type                           value_type;
         typedef typename base_type::pointer                              pointer;
         typedef typename base_type::const_pointer                        const_pointer;
         typedef typename base_type::reference                            reference;
@@ -307,6 +453,402 @@ namespace GHYSTL{
         {
             typedef simple_allocator<value_type> other;
         }; 
+
+        simple_allocator() noexcept {}
+
+        template<typename other_type>
+        simple_allocator(const simple_allocator<other_type>&) noexcept {}
+    };
+
+    template<typename T1, typename T2>
+    inline bool operator==(const simple_allocator<T1>&, const simple_allocator<T2>&) noexcept { return true; }
+
+    template<typename T1, typename T2>
+    inline bool operator!=(const simple_allocator<T1>&, const simple_allocator<T2>&) noexcept { return false; }
+
+
+    // 按 N 字节对齐分配的分配器，例如 aligned_allocator<float, 32> 让 vector 的数据从 32 字节边界开始，方便 SIMD 指令读写
+    // 类型本身的对齐要求比 N 高时按类型的来；rebind 之后的分配器也按 N 对齐
+    // 数组形式的 allocate(n) 把空间补齐到 N 字节的整数倍，按整个 SIMD 宽度读写最后一组元素也不会越界
+    template<typename value_type_, size_t N>
+    class aligned_allocator 
+                : public allocator_base<value_type_, default_alloc, N>
+
+    {
+    public:
+        typedef allocator_base<value_type_, default_alloc, N>            base_type;
+        typedef typename base_type::value_type                           value_type;
+        typedef typename base_type::pointer                              pointer;
+        typedef typename base_type::const_pointer                        const_pointer;
+        typedef typename base_type::reference                            reference;
+        typedef typename base_type::const_reference                      const_reference;
+        typedef typename base_type::size_type                            size_type;
+        typedef typename base_type::difference_type                      difference_type;
+        typedef typename base_type::alloc                                alloc;
+
+        template<typename value_type>
+        struct rebind
+        {
+            typedef aligned_allocator<value_type, N> other;
+        }; 
+
+        aligned_allocator() noexcept {}
+
+        template<typename other_type>
+        aligned_allocator(const aligned_allocator<other_type, N>&) noexcept {}
+
+        using base_type::allocate;
+        using base_type::deallocate;
+
+        inline static pointer allocate(const size_type n){
+            return base_type::allocate(padded(n));
+        }
+
+        inline static void deallocate(pointer ptr, size_type n){
+            base_type::deallocate(ptr, padded(n));
+        }
+
+        inline static pointer reallocate(pointer ptr, size_type old_n, size_type new_n){
+            return base_type::reallocate(ptr, padded(old_n), padded(new_n));
+        }
+
+        // 补齐之后的空间能放下多少个元素，配合 growth_size_class 让容量也是 N 字节的整数倍
+        inline static size_type good_size(size_type n){
+            return padded(n);
+        }
+
+    private:
+        // n 个元素的空间补齐到 N 字节的整数倍之后，能放下多少个元素
+        inline static size_type padded(size_type n){
+            return ((sizeof(value_type) * n + N - 1) & ~(N - 1)) / sizeof(value_type);
+        }
+    };
+
+    template<typename T1, typename T2, size_t N>
+    inline bool operator==(const aligned_allocator<T1, N>&, const aligned_allocator<T2, N>&) noexcept { return true; }
+
+    template<typename T1, typename T2, size_t N>
+    inline bool operator!=(const aligned_allocator<T1, N>&, const aligned_allocator<T2, N>&) noexcept { return false; }
+
+
+    // 结点从 node_pool<T> 上分配的分配器：单个对象的 allocate()/deallocate(ptr) 和批量接口走类型自己的池，
+    // 数组形式的 allocate(n)/deallocate(ptr, n) 仍然交给二级配置器
+    // rebind 之后还是 node_pool_allocator，所以 map/list/unordered_map 的结点都各自成池
+    template<typename value_type_>
+    class node_pool_allocator 
+                : public allocator_base<value_type_, default_alloc>
+
+    {
+    public:
+        typedef allocator_base<value_type_, default_alloc>               base_type;
+        typedef typename base_type::value_type                           value_type;
+        typedef typename base_type::pointer                              pointer;
+        typedef typename base_type::const_pointer                        const_pointer;
+        typedef typename base_type::reference                            reference;
+        typedef typename base_type::const_reference                      const_reference;
+        typedef typename base_type::size_type                            size_type;
+        typedef typename base_type::difference_type                      difference_type;
+        typedef typename base_type::alloc                                alloc;
+        typedef node_pool<value_type>                                    pool;
+
+        template<typename value_type>
+        struct rebind
+        {
+            typedef node_pool_allocator<value_type> other;
+        }; 
+
+        node_pool_allocator() noexcept {}
+
+        template<typename other_type>
+        node_pool_allocator(const node_pool_allocator<other_type>&) noexcept {}
+
+        // 容器按 allocator<T> 声明、结点改用池的时候，两种分配器要能互相转换
+        template<typename other_type>
+        node_pool_allocator(const allocator<other_type>&) noexcept {}
+
+        template<typename other_type>
+        operator allocator<other_type>() const noexcept { return allocator<other_type>(); }
+
+        using base_type::allocate;
+        using base_type::deallocate;
+
+        inline static pointer allocate(){
+            return static_cast<pointer>(pool::allocate());
+        }
+
+        inline static void deallocate(pointer ptr){
+            pool::deallocate(ptr);
+        }
+
+        inline static pointer allocate_batch(size_type n){
+            return static_cast<pointer>(pool::allocate_batch(n));
+        }
+
+        inline static void deallocate_batch(pointer first){
+            pool::deallocate_batch(first);
+        }
+
+        inline static node_pool_stats stats(){ return pool::stats(); }
+    };
+
+    template<typename T1, typename T2>
+    inline bool operator==(const node_pool_allocator<T1>&, const node_pool_allocator<T2>&) noexcept { return true; }
+
+    template<typename T1, typename T2>
+    inline bool operator!=(const node_pool_allocator<T1>&, const node_pool_allocator<T2>&) noexcept { return false; }
+
+
+    // 从 monotonic_arena 上分配空间的分配器，持有 arena 的指针，是一个有状态的分配器
+    // deallocate 什么都不做，空间由 arena 的 reset()/release() 整体回收
+    template<typename value_type_>
+    class arena_allocator 
+                : public allocator_base<value_type_, monotonic_arena> // 只借用 construct/destroy，allocate/deallocate 在下面重新定义
+
+    {
+    public:
+        typedef allocator_base<value_type_, monotonic_arena>             base_type;
+        typedef typename base_type::value_type                           value_type;
+        typedef typename base_type::pointer                              pointer;
+        typedef typename base_type::const_pointer                        const_pointer;
+        typedef typename base_type::reference                            reference;
+        typedef typename base_type::const_reference                      const_reference;
+        typedef typename base_type::size_type                            size_type;
+        typedef typename base_type::difference_type                      difference_type;
+        typedef typename base_type::alloc                                alloc;
+
+        template<typename value_type>
+        struct rebind
+        {
+            typedef arena_allocator<value_type> other;
+        }; 
+
+        explicit arena_allocator(monotonic_arena& arena) noexcept : arena(&arena) {}
+
+        template<typename other_type>
+        arena_allocator(const arena_allocator<other_type>& x) noexcept : arena(x.resource()) {}
+
+        pointer allocate() const {
+            return static_cast<pointer>(arena->allocate(sizeof(value_type), base_type::alignment));
+        }
+
+        pointer allocate(const size_type n) const {
+            return (n ? static_cast<pointer>(arena->allocate(sizeof(value_type) * n, base_type::alignment)) : nullptr);
+        }
+
+        void deallocate(pointer) const noexcept {}
+
+        void deallocate(pointer, size_type) const noexcept {}
+
+        pointer allocate_batch(size_type n) const {
+            static_assert(sizeof(value_type) >= sizeof(void*), "allocate_batch needs room for a link in each block");
+            return static_cast<pointer>(arena->allocate_batch(sizeof(value_type), n, base_type::alignment));
+        }
+
+        void deallocate_batch(pointer) const noexcept {}
+
+        pointer reallocate(pointer ptr, size_type old_n, size_type new_n) const {
+            static_assert(is_trivially_relocatable<value_type>::value,
+                          "reallocate requires a trivially relocatable value_type");
+            if(new_n == 0) return nullptr;
+            return static_cast<pointer>(arena->reallocate(ptr, sizeof(value_type) * old_n, sizeof(value_type) * new_n,
+                                                          base_type::alignment));
+        }
+
+        monotonic_arena* resource() const noexcept { return arena; }
+
+    private:
+        monotonic_arena* arena;
+    };
+
+    // 同一个 arena 上的分配器才能互相释放
+    template<typename T1, typename T2>
+    inline bool operator==(const arena_allocator<T1>& left, const arena_allocator<T2>& right) noexcept { 
+        return left.resource() == right.resource(); 
+    }
+
+    template<typename T1, typename T2>
+    inline bool operator!=(const arena_allocator<T1>& left, const arena_allocator<T2>& right) noexcept { 
+        return !(left == right); 
+    }
+
+    // 判断分配器是否是单调的(deallocate 不回收空间)
+    // 容器的元素又不需要析构时，销毁容器可以不再逐个结点遍历释放
+    template<typename Alloc>
+    struct is_monotonic_alloc : false_type {};
+
+    template<typename value_type>
+    struct is_monotonic_alloc<arena_allocator<value_type>> : true_type {};
+
+    template<typename Alloc, typename value_type>
+    struct is_trivial_teardown 
+        : bool_type<is_monotonic_alloc<Alloc>::value && std::is_trivially_destructible<value_type>::value> {};
+
+
+    // 结点容器(list、rb_tree、hash_table)的结点分配器，默认是 rebind 成结点类型的 Alloc
+    // 定义 GHYSTL_NODE_POOL 之后，用默认 allocator 的结点容器改从 node_pool 分配结点
+    template<typename Alloc, typename node_type>
+    struct node_allocator
+    {
+        typedef typename Alloc::template rebind<node_type>::other type;
+    };
+
+#ifdef GHYSTL_NODE_POOL
+    template<typename value_type, typename node_type>
+    struct node_allocator<allocator<value_type>, node_type>
+    {
+        typedef node_pool_allocator<node_type> type;
+    };
+#endif
+
+
+    /*---------------------------------------------------- 批量分配节点 --------------------------------------------------*/
+
+    // 批量分配得到的链表，每块空间的开头存放下一块的地址
+    template<typename value_type>
+    inline value_type*& batch_next(value_type* ptr){
+        return *reinterpret_cast<value_type**>(ptr);
+    }
+
+    // 判断分配器有没有 allocate_batch(n) / deallocate_batch(first)
+    template<typename Alloc, typename = void>
+    struct has_allocate_batch : false_type {};
+
+    template<typename Alloc>
+    struct has_allocate_batch<Alloc, decltype((void)std::declval<Alloc&>().allocate_batch(size_t()))> : true_type {};
+
+    template<typename Alloc>
+    inline typename Alloc::pointer allocate_nodes_imple(Alloc& a, size_t n, true_type){
+        return a.allocate_batch(n);
+    }
+
+    template<typename Alloc>
+    inline typename Alloc::pointer allocate_nodes_imple(Alloc& a, size_t n, false_type){
+        typename Alloc::pointer head = nullptr;
+        try{
+            for(; n != 0; --n){
+                typename Alloc::pointer p = a.allocate();
+                batch_next(p) = head;
+                head = p;
+            }
+        }
+        catch(...){
+            while(head){
+                typename Alloc::pointer next = batch_next(head);
+                a.deallocate(head);
+                head = next;
+            }
+            throw;
+        }
+        return head;
+    }
+
+    template<typename Alloc>
+    inline void deallocate_nodes_imple(Alloc& a, typename Alloc::pointer first, true_type){
+        a.deallocate_batch(first);
+    }
+
+    template<typename Alloc>
+    inline void deallocate_nodes_imple(Alloc& a, typename Alloc::pointer first, false_type){
+        while(first){
+            typename Alloc::pointer next = batch_next(first);
+            a.deallocate(first);
+            first = next;
+        }
+    }
+
+    // 容器通过下面两个函数批量申请、释放节点，分配器没有批量接口时退化为逐个 allocate/deallocate
+    template<typename Alloc>
+    inline typename Alloc::pointer allocate_nodes(Alloc& a, size_t n){
+        return allocate_nodes_imple(a, n, has_allocate_batch<Alloc>());
+    }
+
+    template<typename Alloc>
+    inline void deallocate_nodes(Alloc& a, typename Alloc::pointer first){
+        if(first) deallocate_nodes_imple(a, first, has_allocate_batch<Alloc>());
+    }
+
+
+    /*---------------------------------------------------- 容器的扩容策略 --------------------------------------------------*/
+
+    // 判断分配器有没有 good_size(n)
+    template<typename Alloc, typename = void>
+    struct has_good_size : false_type {};
+
+    template<typename Alloc>
+    struct has_good_size<Alloc, decltype((void)std::declval<const Alloc&>().good_size(size_t()))> : true_type {};
+
+    template<typename Alloc>
+    inline size_t alloc_good_size_imple(const Alloc& a, size_t n, true_type){
+        return a.good_size(n);
+    }
+
+    template<typename Alloc>
+    inline size_t alloc_good_size_imple(const Alloc&, size_t n, false_type){
+        return n;
+    }
+
+    // 申请 n 个元素时分配器实际给的空间能放下多少个，不知道的时候就是 n
+    template<typename Alloc>
+    inline size_t alloc_good_size(const Alloc& a, size_t n){
+        return alloc_good_size_imple(a, n, has_good_size<Alloc>());
+    }
+
+    // vector、base_string 的空间不够时，由扩容策略决定新的容量
+    // new_capacity(a, cap, need)：cap 是当前容量，need 是至少要有的容量，a 是容器的分配器，返回值不小于 need
+
+    // 每次翻倍，vector 默认的策略
+    struct growth_double
+    {
+        template<typename Alloc>
+        static size_t new_capacity(const Alloc&, size_t cap, size_t need){
+            const size_t n = cap ? 2 * cap : 1;
+            return n < need ? need : n;
+        }
+    };
+
+    // 每次增加一半，base_string 默认的策略，比翻倍省空间，扩容次数多一些
+    struct growth_half
+    {
+        template<typename Alloc>
+        static size_t new_capacity(const Alloc&, size_t cap, size_t need){
+            const size_t n = cap + (cap >> 1);
+            return n < need ? need : n;
+        }
+    };
+
+    // 先按 Base 算出容量，再向上取到分配器实际给的区块大小，区块里多出来的空间不浪费
+    template<typename Base = growth_double>
+    struct growth_size_class
+    {
+        template<typename Alloc>
+        static size_t new_capacity(const Alloc& a, size_t cap, size_t need){
+            return alloc_good_size(a, Base::new_capacity(a, cap, need));
+        }
+    };
+
+
+    /*---------------------------------------------------- 容器持有的分配器实例 --------------------------------------------------*/
+
+    // 容器继承 alloc_holder 来保存分配器实例，allocate/deallocate 都通过这个实例调用
+    // 无状态的分配器(allocator、simple_allocator)是空类，依靠空基类优化不增加容器的大小
+    // 有状态的分配器要把 allocate/deallocate 声明为 const 成员函数，construct/destroy 仍然可以是静态的
+    template<typename Alloc>
+    class alloc_holder : private Alloc
+    {
+    public:
+        alloc_holder() : Alloc() {}
+
+        explicit alloc_holder(const Alloc& a) : Alloc(a) {}
+
+        Alloc& get_alloc() noexcept { return *this; }
+
+        const Alloc& get_alloc() const noexcept { return *this; }
+
+        void swap_alloc(alloc_holder& x) noexcept {
+            Alloc tmp(x.get_alloc());
+            x.get_alloc() = get_alloc();
+            get_alloc() = tmp;
+        }
     };
 
 
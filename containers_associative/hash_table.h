@@ -262,7 +262,10 @@ inline size_t next_prime(size_t n){
 }
 
 template<typename traits>
-class hash_table{
+class hash_table 
+    : private GHYSTL::alloc_holder<typename GHYSTL::node_allocator<typename traits::allocator_type,
+                                                                    hash_table_node<typename traits::value_type>>::type>
+{
 public:
     friend class hash_table_const_iterator<traits>;
     friend class hash_table_iterator<traits>;
@@ -280,7 +283,8 @@ public:
     typedef size_t                  size_type;
     typedef std::ptrdiff_t          difference_type;
 
-    typedef typename allocator_type::template rebind<hash_table_node<value_type>>::other node_alloc; // 哈希表节点的空间配置
+    typedef typename GHYSTL::node_allocator<allocator_type, hash_table_node<value_type>>::type node_alloc; // 哈希表节点的空间配置
+    typedef GHYSTL::alloc_holder<node_alloc>                                            holder_type;
     
     typedef hash_table_const_iterator<traits>                                           const_iterator; // 哈希表节点 和 哈希表
     typedef typename If<is_same<key_type, value_type>::value, const_iterator,
@@ -293,9 +297,15 @@ public:
         is_multi = traits::is_multi
     };
 
+    // 节点来自单调分配器、元素又不需要析构时，清空哈希表不必逐个节点遍历
+    enum{
+        trivial_teardown = GHYSTL::is_trivial_teardown<node_alloc, value_type>::value
+    };
+
     typedef hash_table_node<value_type>*        link_type;
     typedef hash_table<traits>                  self;
-    typedef GHYSTL::vector<link_type>           container;
+    typedef typename allocator_type::template rebind<link_type>::other      bucket_alloc; // 桶数组也从同一个分配器上分配
+    typedef GHYSTL::vector<link_type, bucket_alloc>                         container;
 
     typedef GHYSTL::pair<iterator, bool>                                Pair_IB;
     typedef GHYSTL::pair<local_iterator, local_iterator>                Pair_II;
@@ -305,12 +315,14 @@ public:
 private:
     hasher          hash;       // 哈希算法
     equal_key       equals;     // 键值比较
-    container       buckets;    // 哈希表
+    container       buckets;    // 哈希表，默认构造时是空的，第一次插入时由 resize 分配
     size_type       num_elements; // 元素个数
+    link_type       spare = nullptr; // 批量插入时预先申请好的空节点，用 batch_next 串成链表
 
 public:
 /*-----------------------------------------------构造 析构函数-------------------------------------------------*/
-    hash_table() : hash(), equals(), num_elements(0) { init_buckets(0); }
+    // 不指定桶数时不分配桶数组
+    hash_table() : hash(), equals(), num_elements(0) {}
 
     explicit hash_table(size_t n) : hash(), equals(), num_elements(0) {
         init_buckets(n);
@@ -320,24 +332,33 @@ public:
         init_buckets(n);
     }
 
-    hash_table(const hasher &hash, const equal_key &equals) : hash(hash), equals(equals), num_elements(0) {
-        init_buckets(0);
-    }
+    hash_table(const hasher &hash, const equal_key &equals) : hash(hash), equals(equals), num_elements(0) {}
 
     hash_table(const size_t n, const hasher &hash, const equal_key &equals) : hash(hash), equals(equals), num_elements(0) {
         init_buckets(n);
     }
 
-    hash_table(const self &x) : buckets(x.buckets.size(), nullptr), hash(x.hash),
-                                    equals(x.equals), num_elements(x.num_elements)
+    // 使用指定的分配器实例，节点和桶数组都从这个实例(rebind 之后)上分配
+    hash_table(const size_t n, const hasher &hash, const equal_key &equals, const allocator_type &a) 
+        : holder_type(node_alloc(a)), hash(hash), equals(equals), buckets(bucket_alloc(a)), num_elements(0) {
+        init_buckets(n);
+    }
+
+    hash_table(const self &x) : holder_type(x.get_alloc()), hash(x.hash), equals(x.equals), 
+                                    buckets(x.buckets.size(), nullptr, bucket_alloc(x.get_alloc())), 
+                                    num_elements(x.num_elements)
     {
+        reserve_nodes(x.num_elements);
         for (size_t i = 0; i != buckets.size(); ++i)
             for (link_type cur = x.buckets[i]; cur; cur = cur->next)
                 buckets[i] = create_node(cur->value, buckets[i]); // 头插法
+        release_nodes();
     }
 
-    hash_table(self &&x) : num_elements(x.num_elements), hash(std::move(x.hash)),
-                            equals(std::move(x.equals)), buckets(std::move(x.buckets)) { }
+    hash_table(self &&x) : holder_type(x.get_alloc()), num_elements(x.num_elements), hash(std::move(x.hash)),
+                            equals(std::move(x.equals)), buckets(std::move(x.buckets)) {
+        x.num_elements = 0;
+    }
 
     hash_table& operator=(const hash_table& rhs){
         if(this != &rhs){
@@ -356,9 +377,14 @@ public:
     ~hash_table() { clear(); }
 /*------------------------------------------------- 常规函数 ---------------------------------------------------*/
 
-    size_type bucket(const key_type &k) const { return (get_bucket_num(k)); }
+    // 还没有桶时所有 key 都算在 0 号桶
+    size_type bucket(const key_type &k) const {
+        return (buckets.empty() ? 0 : get_bucket_num(k));
+    }
 
     size_type count(const key_type& k) const {
+        if(empty()) return 0;
+
         size_type counter = 0;
         size_t n = get_bucket_num(k);
 
@@ -374,6 +400,7 @@ public:
         GHYSTL::swap(equals, x.equals);
         GHYSTL::swap(num_elements, x.num_elements);
         buckets.swap(x.buckets);
+        this->swap_alloc(x);
     }
 
     const_iterator find(const key_type &k) const {
@@ -405,7 +432,7 @@ public:
                             const_local_iterator(ret.second)));
     }
 
-    allocator_type get_allocator() const { return (allocator_type()); }
+    allocator_type get_allocator() const { return (allocator_type(this->get_alloc())); }
 
     hasher hash_function() const { return (hash); }
 
@@ -461,12 +488,15 @@ public:
 
     // 装入因子
     float load_factor() const noexcept{ // 每个桶平均有几个元素
+        if(bucket_count() == 0) return 0.0f;
         return ((float)size() / (float)bucket_count());
     }
 
 /*----------------------------------------------- erase -------------------------------------------------*/
 
     size_type erase(const key_type& k){
+        if(empty()) return 0;
+
         size_t n = get_bucket_num(k);
         link_type cur = buckets[n];
         size_type count = 0;
@@ -518,15 +548,21 @@ public:
     }
 
     void clear(){
+        if(empty()) return; // 空表可能还没有桶
+
         const size_t len = buckets.size();
-        for (size_t i = 0; i != len; ++i) {
+        link_type chain = nullptr;
+        for (size_t i = 0; i != len && !trivial_teardown; ++i) {
             for (link_type cur = buckets[i], next; cur; cur = next) {
                 next = cur->next;
-                destroy_and_free_node(cur);
+                node_alloc::destroy(cur);
+                GHYSTL::batch_next(cur) = chain;
+                chain = cur;
             }
         }
+        GHYSTL::deallocate_nodes(this->get_alloc(), chain); // 所有节点一次还给分配器
 
-        memset(&buckets[0], 0, len);
+        memset(&buckets[0], 0, len * sizeof(link_type));
         num_elements = 0;
     }
 
@@ -621,10 +657,7 @@ public:
 
     template <typename IIter>
     void insert(IIter first, IIter last) {
-        
-        for (; first != last; ++first){
-            insert(*first);
-        }     
+        insert_range(first, last, GHYSTL::iterator_category(first));
     }
 
     void insert(const std::initializer_list<value_type> &lst) {
@@ -666,16 +699,63 @@ private:
         return Pair_LL(first, cur);
     }
 
+    template <typename IIter>
+    void insert_range(IIter first, IIter last, GHYSTL::input_iterator_tag) {
+        for (; first != last; ++first)
+            insert(*first);
+    }
+
+    // 元素个数事先知道：节点整批申请，重复的 key 剩下的节点最后一起还回去
+    template <typename IIter>
+    void insert_range(IIter first, IIter last, GHYSTL::forward_iterator_tag) {
+        const size_type n = GHYSTL::distance(first, last);
+        reserve_buckets(n, GHYSTL::bool_type<is_multi>());
+        reserve_nodes(n);
+        try{
+            for (; first != last; ++first)
+                insert(*first);
+        }
+        catch(...){
+            release_nodes();
+            throw;
+        }
+        release_nodes();
+    }
+
+    // 可重复的表每个元素都会插进来，桶只调整一次
+    void reserve_buckets(size_type n, GHYSTL::true_type) {
+        resize(num_elements + n);
+    }
+
+    // 不可重复的表事先不知道有多少重复的 key，按 n 调整会让桶数虚高；
+    // 交给逐个插入时的 resize，桶数按实际插入的元素个数成倍增长
+    void reserve_buckets(size_type, GHYSTL::false_type) {}
+
+    // 一次向分配器申请 n 个节点，之后创建节点时从里面取
+    void reserve_nodes(size_type n) {
+        spare = GHYSTL::allocate_nodes(this->get_alloc(), n);
+    }
+
+    // 归还没用完的节点
+    void release_nodes() {
+        GHYSTL::deallocate_nodes(this->get_alloc(), spare);
+        spare = nullptr;
+    }
+
     template<typename ... types>
     link_type create_node(types&& ... args){
-        link_type node = node_alloc::allocate();
+        link_type node = spare;
+        if(node)
+            spare = GHYSTL::batch_next(spare);
+        else
+            node = this->get_alloc().allocate();
         node_alloc::construct(node, std::forward<types>(args)...);
         return node;
     }
 
     void destroy_and_free_node(link_type node) {
         node_alloc::destroy(node);
-        node_alloc::deallocate(node);
+        this->get_alloc().deallocate(node);
     }
 
     void init_buckets(const size_type n) {
@@ -699,6 +779,8 @@ private:
     }
 
     link_type find_imple(const key_type& key) const {
+        if(empty()) return nullptr; // 空表可能还没有桶
+
         size_t n = get_bucket_num(key);
         link_type cur = buckets[n];
 
@@ -805,7 +887,7 @@ private:
             const size_type n = next_prime(new_n);
             
             if(n > old_n){
-                container tmp(n, nullptr);
+                container tmp(n, nullptr, buckets.get_allocator());
                 size_type new_bucket_num;
                 for(size_type i = 0; i != old_n; ++i){
                     for(link_type first = buckets[i]; first; first = buckets[i]){
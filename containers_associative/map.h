@@ -57,6 +57,7 @@ protected:
     typedef data_type_                                          data_type;
     typedef GHYSTL::pair<const key_type, data_type>             value_type;
     typedef Compare                                             Key_Compare;
+    typedef Alloc                                               allocator_type;
 
     typedef rb_tree<map_traits<key_type, data_type, Key_Compare, Alloc, false>>             base_type; //红黑树
     typedef map<key_type, data_type, Key_Compare>                                           self;
@@ -77,6 +78,10 @@ public:
 
     explicit map(const Compare& cmp) : base_type(cmp) {}
 
+    explicit map(const allocator_type& a) : base_type(Compare(), a) {}
+
+    map(const Compare& cmp, const allocator_type& a) : base_type(cmp, a) {}
+
     template<typename Iter>
     map(Iter first, Iter last) : base_type() {
         base_type::insert(first, last);
@@ -144,6 +149,7 @@ public:
     typedef data_type_                                        data_type;
     typedef GHYSTL::pair<const key_type, data_type>           value_type;
     typedef Compare                                           key_Compare;
+    typedef Alloc                                             allocator_type;
 
     typedef rb_tree<map_traits<key_type, data_type, key_Compare, Alloc, true>>    base_type;
     typedef multi_map<key_type, data_type, key_Compare>                           self;
@@ -163,6 +169,10 @@ public:
 
     explicit multi_map(const Compare &comp) : base_type(comp) {}
 
+    explicit multi_map(const allocator_type &a) : base_type(Compare(), a) {}
+
+    multi_map(const Compare &comp, const allocator_type &a) : base_type(comp, a) {}
+
     template <typename Iter>
     multi_map(Iter first, Iter last) : base_type() {
         base_type::insert(first, last);
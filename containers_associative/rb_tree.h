@@ -264,7 +264,10 @@ public:
 
 /******************************************* 红黑树 ***************************************/
 template<typename traits>
-class rb_tree{
+class rb_tree 
+    : private GHYSTL::alloc_holder<typename GHYSTL::node_allocator<typename traits::allocator_type,
+                                                                    rb_tree_node<typename traits::value_type>>::type>
+{
 protected:
     typedef rb_tree<traits>                     self;
     typedef typename traits::key_type           key_type;
@@ -287,13 +290,19 @@ protected:
 
 
     typedef allocator_type          data_alloc;
-    typedef typename allocator_type::template rebind<node_type>::other                  node_alloc;
+    typedef typename GHYSTL::node_allocator<allocator_type, node_type>::type            node_alloc;
     typedef typename allocator_type::template rebind<base_node_type>::other             base_alloc;
+    typedef GHYSTL::alloc_holder<node_alloc>                                            holder_type;
     
     enum{
         is_multi = traits::is_multi
     };
 
+    // 结点来自单调分配器、元素又不需要析构时，清空整棵树不必逐个结点遍历
+    enum{
+        trivial_teardown = GHYSTL::is_trivial_teardown<node_alloc, value_type>::value
+    };
+
 
     typedef typename traits::key_compare    key_compare;
     typedef key_compare                     Compare;
@@ -316,6 +325,7 @@ private:
     link_type   root;
     size_type   node_count;
     Compare     comp; // 类型是 key_compare
+    link_type   spare = nullptr; // 批量插入时预先申请好的空结点，用 batch_next 串成链表
 
 public:
 
@@ -326,16 +336,23 @@ public:
 
     explicit rb_tree(const Compare& comp): nil(create_nil()), root(nil), comp(comp), node_count(0) {}
 
-    rb_tree(const self& x) : nil(create_nil()), root(nil), comp(x.comp), node_count(0){
-        if(x.get_root() != x.get_nil())
+    // 使用指定的分配器实例，结点都从这个实例(rebind 成结点类型)上分配
+    rb_tree(const Compare& comp, const allocator_type& a)
+        : holder_type(node_alloc(a)), nil(create_nil()), root(nil), comp(comp), node_count(0) {}
+
+    rb_tree(const self& x) : holder_type(x.get_alloc()), nil(create_nil()), root(nil), comp(x.comp), node_count(0){
+        if(x.get_root() != x.get_nil()){
+            reserve_nodes(x.node_count);
             root = copy_assign(root, x.get_root(), x.get_nil());
+            release_nodes();
+        }
         
         node_count = x.node_count;
         nil->left = maximum(get_root());
         nil->right = minimum(get_root());
     }
 
-    rb_tree(self&& x) : nil(x.nil), root(x.root), comp(x.comp), node_count(x.node_count){
+    rb_tree(self&& x) : holder_type(x.get_alloc()), nil(x.nil), root(x.root), comp(x.comp), node_count(x.node_count){
         x.nil = x.root = nullptr;
         x.node_count = 0;
     }
@@ -343,9 +360,10 @@ public:
     self& operator=(const self& x){
         if(this != &x){
             if(x.node_count != 0){
-                clear();
-                nil = create_nil();
+                clear(); // clear 之后 root 就是 nil，新树直接挂在原来的 nil 上
+                reserve_nodes(x.node_count);
                 root = copy_assign(root, x.get_root(), x.get_nil());
+                release_nodes();
                 nil->left = maximum(get_root());
                 nil->right = minimum(get_root());
             }
@@ -358,6 +376,8 @@ public:
 
     self& operator=(self&& x){
         clear();
+        destroy_nil();
+        this->get_alloc() = x.get_alloc(); // 接管 x 的结点，也要接管分配这些结点的分配器
         nil = std::move(x.nil);
         root = std::move(x.root);
         comp = x.comp;
@@ -369,7 +389,7 @@ public:
     }
 
     ~rb_tree(){
-        if(!empty())
+        if(!empty() && !trivial_teardown)
             rb_destroy(get_root());
         destroy_nil();
     }
@@ -377,7 +397,7 @@ public:
 /*-------------------------------------------- 常规操作 -----------------------------------------------------*/
 public:
     void clear(){
-        if(!empty())
+        if(!empty() && !trivial_teardown)
             rb_destroy(get_root());
 
         root = nil;
@@ -390,6 +410,7 @@ public:
         GHYSTL::swap(root, x.root);
         GHYSTL::swap(comp, x.comp);
         GHYSTL::swap(node_count, x.node_count);
+        this->swap_alloc(x);
     }
 
     size_type size() const { return node_count; }
@@ -401,7 +422,7 @@ public:
         return GHYSTL::distance(range.first, range.second);
     }
 
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
 
     key_compare key_comp() const { return key_compare(); }
     
@@ -497,8 +518,7 @@ public:
     
     template<typename Iter>
     void insert(Iter first, Iter last){
-        for(; first != last; ++first)
-            insert(*first);
+        insert_range(first, last, GHYSTL::iterator_category(first));
     }
 
     void insert(const std::initializer_list<value_type>& lst){
@@ -579,14 +599,56 @@ protected:
             data_alloc::construct(std::addressof(ptr->value), std::forward<types>(args)...);
         }
         catch(...){
-            node_alloc::deallocate(ptr);
+            this->get_alloc().deallocate(ptr);
             throw;
         }
     }
 
+    // 有预先申请的结点就先用掉，否则向分配器要一个
+    link_type allocate_node(){
+        if(spare){
+            link_type ptr = spare;
+            spare = GHYSTL::batch_next(spare);
+            return ptr;
+        }
+        return this->get_alloc().allocate();
+    }
+
+    // 一次向分配器申请 n 个结点，之后创建结点时从里面取
+    void reserve_nodes(size_type n){
+        spare = GHYSTL::allocate_nodes(this->get_alloc(), n);
+    }
+
+    // 归还没用完的结点
+    void release_nodes(){
+        GHYSTL::deallocate_nodes(this->get_alloc(), spare);
+        spare = nullptr;
+    }
+
+    template<typename Iter>
+    void insert_range(Iter first, Iter last, GHYSTL::input_iterator_tag){
+        for(; first != last; ++first)
+            insert(*first);
+    }
+
+    // 元素个数事先知道，结点整批申请，重复的 key 剩下的结点最后一起还回去
+    template<typename Iter>
+    void insert_range(Iter first, Iter last, GHYSTL::forward_iterator_tag){
+        reserve_nodes(GHYSTL::distance(first, last));
+        try{
+            for(; first != last; ++first)
+                insert(*first);
+        }
+        catch(...){
+            release_nodes();
+            throw;
+        }
+        release_nodes();
+    }
+
     link_type create_node(rb_tree_color_type color, link_type parent){
         
-        link_type ptr = node_alloc::allocate();
+        link_type ptr = allocate_node();
 
         try{
             ptr->color = color;
@@ -595,7 +657,7 @@ protected:
             ptr->right = nullptr;
         }
         catch(...){
-            node_alloc::deallocate(ptr);
+            this->get_alloc().deallocate(ptr);
         }
 
         return ptr;
@@ -603,7 +665,7 @@ protected:
 
     template<typename ... types>
     link_type create_insert_node(link_type par, types&&... args){
-        link_type tar = node_alloc::allocate();
+        link_type tar = allocate_node();
     
         try{
             node_alloc::construct(tar, std::forward<types>(args)..., red, par, nil, nil); 
@@ -614,7 +676,7 @@ protected:
             // tar->parent = par;
         }
         catch(...){
-            node_alloc::deallocate(tar);
+            this->get_alloc().deallocate(tar);
             throw;
         }
         
@@ -623,7 +685,7 @@ protected:
 
     void destroy_and_free_node(link_type node){
         data_alloc::destroy(std::addressof(node->value));
-        node_alloc::deallocate(node);
+        this->get_alloc().deallocate(node);
     }
 
     link_type get_root() const { return root; }
@@ -631,13 +693,13 @@ protected:
     link_type get_nil() const { return nil; }
 
     link_type create_nil() const{
-        link_type ptr = node_alloc::allocate();
+        link_type ptr = this->get_alloc().allocate();
         node_alloc::construct(ptr, black, nullptr, ptr, ptr); // 试一下这种构造方式，看能不能自动对应变量
         return ptr;
     }
 
     void destroy_nil() const {
-        node_alloc::deallocate(nil);
+        if(nil) this->get_alloc().deallocate(nil);
     }
     
     static link_type minimum(link_type rt) { return node_type::minimum(rt); }
@@ -651,6 +713,8 @@ protected:
 
     void rb_destroy(link_type x); // 销毁树
 
+    void rb_unlink(link_type x, link_type& chain); // 析构结点并串到 chain 上
+
     void rb_delete(link_type tar); 
 
     void rb_delete_fixup(link_type tar); // 删除节点
@@ -793,11 +857,20 @@ protected:
 
 template<typename traits>
 void rb_tree<traits>::rb_destroy(link_type x){
+    link_type chain = nullptr;
+    rb_unlink(x, chain);
+    GHYSTL::deallocate_nodes(this->get_alloc(), chain); // 整棵树的结点一次还给分配器
+}
+
+template<typename traits>
+void rb_tree<traits>::rb_unlink(link_type x, link_type& chain){
     if(x->left != nil)
-        rb_destroy(x->left);
+        rb_unlink(x->left, chain);
     if(x->right != nil)
-        rb_destroy(x->right);
-    destroy_and_free_node(x);
+        rb_unlink(x->right, chain);
+    data_alloc::destroy(std::addressof(x->value));
+    GHYSTL::batch_next(x) = chain;
+    chain = x;
 }
 
 template<typename traits>
@@ -41,6 +41,7 @@ public:
     typedef key_type_                             key_type;
     typedef key_type                              value_type;
     typedef Compare                               key_compare;
+    typedef Alloc                                 allocator_type;
 
     typedef rb_tree<set_traits<key_type, key_compare, Alloc, false>>      base_type;
 
@@ -64,6 +65,10 @@ public:
 
     explicit set(const Compare& comp) : base_type(comp) {}
 
+    explicit set(const allocator_type& a) : base_type(Compare(), a) {}
+
+    set(const Compare& comp, const allocator_type& a) : base_type(comp, a) {}
+
     set(const self& x) : base_type(x) {}
 
     template <typename Iter>
@@ -113,6 +118,7 @@ public:
     typedef key_type_                     key_type;
     typedef key_type                      value_type;
     typedef Compare                       key_compare;
+    typedef Alloc                         allocator_type;
 
     typedef rb_tree<set_traits<key_type, Compare, Alloc, true>>   base_type;
 
@@ -134,6 +140,10 @@ public:
 
     explicit multi_set(const Compare& comp) : base_type(comp) {}
 
+    explicit multi_set(const allocator_type& a) : base_type(Compare(), a) {}
+
+    multi_set(const Compare& comp, const allocator_type& a) : base_type(comp, a) {}
+
     multi_set(const self& x) : base_type(x) {}
 
     template <typename Iter>
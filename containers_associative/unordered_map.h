@@ -69,6 +69,7 @@ public:
     typedef typename base_type::hasher            hasher;
     typedef typename base_type::equal_key         equal_key;
     typedef typename base_type::size_type         size_type;
+    typedef typename base_type::allocator_type    allocator_type;
 
     typedef unordered_map<key_type, data_type, Hash_Function, Equal_Key, Alloc>     self;
 
@@ -91,6 +92,9 @@ public:
     unordered_map(const size_type n, const hasher &hf, const equal_key &eql)
         : base_type(n, hf, eql) {}
 
+    unordered_map(const size_type n, const hasher &hf, const equal_key &eql, const allocator_type &a)
+        : base_type(n, hf, eql, a) {}
+
     unordered_map(const std::initializer_list<value_type>& lst) : base_type()
     {
         base_type::insert(lst.begin(), lst.end());
@@ -189,6 +193,7 @@ public:
     typedef typename base_type::hasher                hasher;
     typedef typename base_type::equal_key             key_equal;
     typedef typename base_type::size_type             size_type;
+    typedef typename base_type::allocator_type        allocator_type;
 
     typedef unordered_multimap<key_type, data_type, Hash_Function, Equal_Key, Alloc>      self;
 
@@ -209,6 +214,9 @@ public:
     unordered_multimap(const size_type n, const hasher &hf, const key_equal &eql)
         : base_type(n, hf, eql) {}
 
+    unordered_multimap(const size_type n, const hasher &hf, const key_equal &eql, const allocator_type &a)
+        : base_type(n, hf, eql, a) {}
+
     unordered_multimap(const std::initializer_list<value_type>& lst) : base_type()
     {
         base_type::insert(lst.begin(), lst.end());
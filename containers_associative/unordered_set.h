@@ -55,6 +55,7 @@ public:
     typedef typename base_type::hasher                hasher;
     typedef typename base_type::equal_key             key_equal;
     typedef typename base_type::size_type             size_type;
+    typedef typename base_type::allocator_type        allocator_type;
 
     typedef typename base_type::difference_type       difference_type;
     typedef typename base_type::const_pointer         pointer;
@@ -76,6 +77,9 @@ public:
 
     unordered_set(const size_type n, const hasher &hf, const key_equal &eql) : base_type(n, hf, eql) {}
 
+    unordered_set(const size_type n, const hasher &hf, const key_equal &eql, const allocator_type &a)
+        : base_type(n, hf, eql, a) {}
+
     template <typename IIter>
     unordered_set(IIter first, IIter last) : base_type()
     {
@@ -155,6 +159,7 @@ public:
     typedef typename base_type::hasher                hasher;
     typedef typename base_type::equal_key             key_equal;
     typedef typename base_type::size_type             size_type;
+    typedef typename base_type::allocator_type        allocator_type;
 
     typedef typename base_type::difference_type       difference_type;
     typedef typename base_type::const_pointer         pointer;
@@ -176,6 +181,9 @@ public:
 
     unordered_multiset(const size_type n, const hasher &hf, const key_equal &eql) : base_type(n, hf, eql) {}
 
+    unordered_multiset(const size_type n, const hasher &hf, const key_equal &eql, const allocator_type &a)
+        : base_type(n, hf, eql, a) {}
+
     template <typename IIter>
     unordered_multiset(IIter first, IIter last) : base_type()
     {
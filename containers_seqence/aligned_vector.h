@@ -0,0 +1,38 @@
+/**
+ * @file aligned_vector.h
+ * @brief aligned_vector：数据按 SIMD 宽度对齐、空间补齐到 SIMD 宽度整数倍的 vector
+ *
+ * @version 1.0
+ *
+ */
+
+#pragma once
+#ifndef _ALIGNED_VECTOR_H_
+#define _ALIGNED_VECTOR_H_
+
+#include "vector.h"
+
+namespace GHYSTL{
+
+    // data() 从 Align 字节边界开始，分配的空间是 Align 字节的整数倍(见 aligned_allocator)，
+    // 扩容时容量也取到 Align 字节的整数倍(growth_size_class 按 aligned_allocator::good_size 取整)
+    // 向量化的循环可以从 data() 开始按整个 SIMD 宽度处理到 padded_size()，不用单独处理头尾
+    // 迭代器还是 vector_iterator，GHYSTL 的算法照常使用
+    template<class T, size_t Align = 64>
+    using aligned_vector = GHYSTL::vector<T, GHYSTL::aligned_allocator<T, Align>, GHYSTL::growth_size_class<>>;
+
+    // 一个 SIMD 宽度放得下多少个 T
+    template<class T, size_t Align = 64>
+    struct simd_width
+    {
+        static_assert(Align % sizeof(T) == 0, "element size must divide the SIMD width");
+        enum { value = Align / sizeof(T) };
+    };
+
+    // size() 向上取到 SIMD 宽度的整数倍，[data() + size(), data() + padded_size()) 是可以读写的补齐空间
+    template<class T, size_t Align>
+    inline size_t padded_size(const aligned_vector<T, Align>& v){
+        return (v.size() + simd_width<T, Align>::value - 1) / simd_width<T, Align>::value * simd_width<T, Align>::value;
+    }
+}
+#endif
@@ -19,17 +19,60 @@
 #define DEQUE_MAP_INIT_SIZE 8
 #endif
 
+// 头部或尾部空出来的缓冲区最多留几个备用，另一端需要新缓冲区时先用备用的
+#ifndef DEQUE_SPARE_BLOCKS
+#define DEQUE_SPARE_BLOCKS 2
+#endif
+
+#include <cstring>
+
 #include "../algorithm/algorithm.h"
 
 namespace GHYSTL{
 
+// 不超过 n 的最大的 2 的幂
+constexpr size_t deque_floor_pow2(size_t n, size_t p = 1){
+    return p > n / 2 ? p : deque_floor_pow2(n, p << 1);
+}
+
+constexpr size_t deque_log2(size_t n){
+    return n <= 1 ? 0 : 1 + deque_log2(n >> 1);
+}
+
+// 缓冲区默认大小：不超过 4096 字节的 2 的幂个元素，大元素 16 个
+// 是 2 的幂时迭代器的下标计算只用移位和掩码
 template <class T>
 struct deque_buf_size
 {
-    static constexpr size_t value = sizeof(T) < 256 ? 4096 / sizeof(T) : 16;
+    static constexpr size_t value = sizeof(T) < 256 ? deque_floor_pow2(4096 / sizeof(T)) : 16;
 };
 
-template<typename value_type_>
+// 相对缓冲区开头的偏移 off 换算成 (缓冲区偏移, 缓冲区内下标)，off 可以是负数，向下取整
+template<size_t BufSize, bool = (BufSize & (BufSize - 1)) == 0>
+struct deque_index
+{
+    static ptrdiff_t node_offset(ptrdiff_t off){
+        const ptrdiff_t n = static_cast<ptrdiff_t>(BufSize);
+        return off >= 0 ? off / n : -((-off - 1) / n) - 1;
+    }
+
+    static ptrdiff_t slot(ptrdiff_t off){
+        return off - node_offset(off) * static_cast<ptrdiff_t>(BufSize);
+    }
+};
+
+// 2 的幂：算术右移就是向下取整的除法，补码下的掩码就是非负的余数
+template<size_t BufSize>
+struct deque_index<BufSize, true>
+{
+    static constexpr size_t shift = deque_log2(BufSize);
+
+    static ptrdiff_t node_offset(ptrdiff_t off) { return off >> shift; }
+
+    static ptrdiff_t slot(ptrdiff_t off) { return off & static_cast<ptrdiff_t>(BufSize - 1); }
+};
+
+template<typename value_type_, size_t BufSize = deque_buf_size<value_type_>::value>
 class deque_const_iterator : public GHYSTL::iterator_base<random_access_iterator_tag, value_type_>
 {
 public:
@@ -41,7 +84,8 @@ public:
     typedef ptrdiff_t                               difference_type;
 
     typedef const pointer*                          map_pointer;
-    typedef deque_const_iterator<value_type>        self;
+    typedef deque_const_iterator<value_type, BufSize>   self;
+    typedef deque_index<BufSize>                    index;
 
     // 迭代器所含成员数据
     pointer         cur;    // 指向所在缓冲区的当前元素
@@ -49,7 +93,7 @@ public:
     pointer         last;   // 指向所在缓冲区的尾部
     map_pointer     node;   // 缓冲区所在节点
 
-    static const size_type buffer_size = deque_buf_size<value_type>::value;
+    static const size_type buffer_size = BufSize;
 
     /*-------------------------------------- 构造函数 ---------------------------------------------*/
 
@@ -102,7 +146,7 @@ public:
 
     pointer operator->() const { return cur; }
 
-    reference operator[](difference_type off) const { return *(*(this + off)); }
+    reference operator[](difference_type off) const { return *(*this + off); }
 
     self& operator++(){
         ++cur;
@@ -140,10 +184,8 @@ public:
         if(offset >= 0 && offset < static_cast<difference_type>(buffer_size)){
             cur += n;
         }else{
-            const auto node_offset = offset > 0 ? offset / static_cast<difference_type>(buffer_size) 
-                                        : static_cast<difference_type>((-offset -1) / buffer_size) - 1;
-            set_node(node + node_offset);
-            cur = first + (offset - node_offset * static_cast<difference_type>(buffer_size));
+            set_node(node + index::node_offset(offset));
+            cur = first + index::slot(offset);
         }
         return *this;
     }
@@ -169,8 +211,8 @@ public:
 };
 
 
-template<typename value_type_>
-class deque_iterator : public deque_const_iterator<value_type_>
+template<typename value_type_, size_t BufSize = deque_buf_size<value_type_>::value>
+class deque_iterator : public deque_const_iterator<value_type_, BufSize>
 {
 public:
     typedef GHYSTL::random_access_iterator_tag      iterator_category;
@@ -181,8 +223,9 @@ public:
     typedef ptrdiff_t                               difference_type;
 
     typedef pointer*                                map_pointer;
-    typedef deque_iterator<value_type>              self;
-    typedef deque_const_iterator<value_type>        iterator_base;
+    typedef deque_iterator<value_type, BufSize>         self;
+    typedef deque_const_iterator<value_type, BufSize>   iterator_base;
+    typedef deque_index<BufSize>                        index;
 
     
     // 迭代器所含成员数据
@@ -191,7 +234,7 @@ public:
     pointer         last;   // 指向所在缓冲区的尾部
     map_pointer     node;   // 缓冲区所在节点
 
-    static const size_type buffer_size = deque_buf_size<value_type>::value;
+    static const size_type buffer_size = BufSize;
 
     deque_iterator() : cur(nullptr), first(nullptr), last(nullptr), node(nullptr) {} //默认构造函数
 
@@ -248,7 +291,7 @@ public:
 
     pointer operator->() const { return cur; }
 
-    reference operator[](difference_type off) const { return *(*(this + off)); }
+    reference operator[](difference_type off) const { return *(*this + off); }
 
     self& operator++(){
         ++cur;
@@ -286,10 +329,8 @@ public:
         if(offset >= 0 && offset < static_cast<difference_type>(buffer_size)){
             cur += n;
         }else{
-            const auto node_offset = offset > 0 ? offset / static_cast<difference_type>(buffer_size) 
-                                        : static_cast<difference_type>((-offset -1) / buffer_size) - 1;
-            set_node(node + node_offset);
-            cur = first + (offset - node_offset * static_cast<difference_type>(buffer_size));
+            set_node(node + index::node_offset(offset));
+            cur = first + index::slot(offset);
         }
         return *this;
     }
@@ -315,8 +356,13 @@ public:
 };
 
 
-template<typename value_type_, typename Alloc = GHYSTL::allocator<value_type_>, typename = void>
-class deque{
+// BufSize 是每个缓冲区的元素个数，取 2 的幂时随机访问只用移位和掩码
+template<typename value_type_, typename Alloc = GHYSTL::allocator<value_type_>,
+         size_t BufSize = deque_buf_size<value_type_>::value>
+class deque : private GHYSTL::alloc_holder<Alloc>
+{
+    static_assert(BufSize > 0, "deque buffer must hold at least one element");
+
 public:
     typedef     value_type_                             value_type;
     typedef     value_type*                             pointer;
@@ -328,49 +374,68 @@ public:
     typedef     pointer*                                map_type;
     typedef     const pointer*                          const_map_type;
 
-    typedef     deque_iterator<value_type>                          iterator;
-    typedef     deque_const_iterator<value_type>                    const_iterator;
+    typedef     deque_iterator<value_type, BufSize>                 iterator;
+    typedef     deque_const_iterator<value_type, BufSize>           const_iterator;
     typedef     GHYSTL::reverse_iterator<iterator>                  reverse_iterator;
     typedef     GHYSTL::reverse_iterator<const_iterator>            const_reverse_iterator;
 
-    typedef     deque<value_type, Alloc, void>                                   self;
+    typedef     deque<value_type, Alloc, BufSize>                                self;
     typedef     Alloc                                                            allocator_type;
     typedef     Alloc                                                            alloc;
     typedef     typename allocator_type::template rebind<pointer>::other         map_alloc; // rebind是一个模板，要特别声明
+    typedef     GHYSTL::alloc_holder<Alloc>                                      holder_type;
 
-    static const size_type buffer_size = deque_buf_size<value_type>::value;
+    static const size_type buffer_size = BufSize;
+    typedef     deque_index<BufSize>                                             index;
 
 private:
     iterator     _begin;  //第一个元素
     iterator     _end;   //最后一个元素
-    map_type     map;    //主控中心
-    size_type    map_size;   // map 内的指针数目
+    map_type     map = nullptr;    //主控中心
+    size_type    map_size = 0;   // map 内的指针数目
+    pointer      spare[DEQUE_SPARE_BLOCKS] = {}; // 备用缓冲区，空位是 nullptr
+
+    // map 里只有 [_begin.node, _end.node] 指向缓冲区，其余都是 nullptr
+    // 空的 deque 可以没有 map(map == nullptr)，迭代器全是空指针，第一次插入时才分配
 
 public:
     /*---------------------------------------------------- 构造函数和常规函数 ------------------------------------------------------*/
 
-    deque() { copy_n_default(0, value_type()); }
+    // 默认构造不分配 map 和缓冲区
+    deque() {}
 
-    explicit deque(const size_type n)  { copy_n_default(n, value_type(0)); } 
+    // 使用指定的分配器实例，缓冲区和 map 都从这个实例(map 用 rebind 之后的)上分配
+    explicit deque(const allocator_type& a) : holder_type(a) {}
 
-    deque(const size_type n, const value_type& val) { copy_n_default(n, val); } 
+    explicit deque(const size_type n, const allocator_type& a = allocator_type()) 
+        : holder_type(a) { copy_n_default(n, value_type(0)); } 
 
-    deque(const std::initializer_list<value_type>& lst) : deque(lst.begin(), lst.end()) {} 
+    deque(const size_type n, const value_type& val, const allocator_type& a = allocator_type()) 
+        : holder_type(a) { copy_n_default(n, val); } 
+
+    deque(const std::initializer_list<value_type>& lst, const allocator_type& a = allocator_type()) 
+        : deque(lst.begin(), lst.end(), a) {} 
 
     template<typename Iter,
             typename = typename enable_if<is_iterator<Iter>::value, void>::type>
-    deque(Iter bg, Iter ed){
+    deque(Iter bg, Iter ed, const allocator_type& a = allocator_type()) : holder_type(a) {
         // copy_init(bg, ed, GHYSTL::iterator_category(bg)); // 注意萃取器的使用 
         // copy_init(bg, ed, GHYSTL::iter_cate_t<Iter>()); 
         copy_init(bg, ed, typename GHYSTL::iterator_traits<Iter>::iterator_category()); 
     }
 
-    deque(const self& x) { copy_init(x.begin(), x.end(), GHYSTL::forward_iterator_tag()); } // 拷贝构造函数
+    deque(const self& x) : holder_type(x.get_alloc()) { // 拷贝构造函数
+        copy_init(x.begin(), x.end(), GHYSTL::forward_iterator_tag()); 
+    } 
 
-    deque(self&& x) noexcept : 
+    deque(self&& x) noexcept : holder_type(x.get_alloc()),
         _begin(std::move(x._begin)), _end(std::move(x._end)), map(x.map), map_size(x.map_size){ // 移动构造函数
         x.map = nullptr;
         x.map_size = 0;
+        for (size_type i = 0; i < DEQUE_SPARE_BLOCKS; ++i){
+            spare[i] = x.spare[i];
+            x.spare[i] = nullptr;
+        }
     }
 
     self& operator=(const self& x);
@@ -384,38 +449,29 @@ public:
 
     ~deque(){
         if(map != nullptr){
-            for (auto cur = map; cur < map + map_size; ++cur){
-                alloc::deallocate(*cur, buffer_size);
-                *cur = nullptr;
-            }
+            clear();
+            this->get_alloc().deallocate(*_begin.node, buffer_size);
+            release_spare();
+            get_map_alloc().deallocate(map, map_size);
             map = nullptr;
             map_size = 0;
         }
     }
 
     void swap(self& x) noexcept {
-        if(this != x){
+        if(this != &x){
             GHYSTL::swap(map, x.map);
             GHYSTL::swap(_begin, x._begin);
             GHYSTL::swap(_end, x._end);
             GHYSTL::swap(map_size, x.map_size);
+            for (size_type i = 0; i < DEQUE_SPARE_BLOCKS; ++i)
+                GHYSTL::swap(spare[i], x.spare[i]);
+            this->swap_alloc(x);
         }
     }
 
-    void shrink_to_fit() noexcept {
-        // 保留数据部分
-        for (auto cur = map; cur < _begin.node; ++cur){
-            alloc::deallocate(*cur, buffer_size);
-            *cur = nullptr;
-        }
-        for (auto cur = _end.node + 1; cur < map + map_size; ++cur){
-            alloc::deallocate(*cur, buffer_size);
-            *cur = nullptr;
-        }
-
-        map = _begin.node;
-        map_size = GHYSTL::distance(_begin.node, _end.node);
-    }
+    // 只保留存有元素的缓冲区，备用的缓冲区还给分配器
+    void shrink_to_fit() noexcept { release_spare(); }
 
     void resize(size_type new_size) { resize(new_size, value_type()); }
 
@@ -430,7 +486,7 @@ public:
 
     bool empty() const noexcept { return _begin == _end; }
 
-    allocator_type get_allocater() const { return allocator_type(); }
+    allocator_type get_allocater() const { return this->get_alloc(); }
 
 
     iterator erase(iterator bg, iterator ed){
@@ -440,19 +496,24 @@ public:
         }
         else{
             const size_type len = ed - bg;
-            const size_type elems_before = _end - _begin;
+            const size_type elems_before = bg - _begin;
 
+            // 搬完之后落在 [_begin, _end) 以外的缓冲区要还回去，map 上 begin.node 到 end.node 以外的位置保持为空
             if (elems_before < ((size() - len) / 2)){
                 GHYSTL::copy_backward(_begin, bg, ed);
                 auto new_begin = _begin + len;
-                alloc::destroy(_begin.cur, new_begin.cur);
+                destroy_elements(_begin, new_begin);
+                if (new_begin.node != _begin.node)
+                    destroy_buffer(_begin.node, new_begin.node - 1);
                 _begin = new_begin;
             }
             else
             {
                 GHYSTL::copy(ed, _end, bg);
                 auto new_end = _end - len;
-                alloc::destroy(new_end.cur, _end.cur);
+                destroy_elements(new_end, _end);
+                if (new_end.node != _end.node)
+                    destroy_buffer(new_end.node + 1, _end.node);
                 _end = new_end;
             }
             return _begin + elems_before;
@@ -476,12 +537,13 @@ public:
         return _begin + elems_before;
     }
 
-    // 清空 deque 元素，空间保留
+    // 清空 deque 元素，保留第一个缓冲区，其余的放进备用或者释放
     void clear(){
+        if (map == nullptr) return;
+
         // 因为底层的 destr 是对指针操作，iteartor的 ++ 重载了，指针不行
         // 所以要分开释放
         for (map_type cur = _begin.node + 1; cur < _end.node; ++cur){
-            // 清空 deque 元素，但没释放空间
             alloc::destroy(*cur, *cur + buffer_size);
         }
 
@@ -489,12 +551,12 @@ public:
         { // 有两个以上的缓冲区
             alloc::destroy(_begin.cur, _begin.last);
             alloc::destroy(_end.first, _end.cur);
+            destroy_buffer(_begin.node + 1, _end.node);
         }
         else
         {
-            alloc::destroy(_begin.cur, _begin.last);
+            alloc::destroy(_begin.cur, _end.cur);
         }
-        shrink_to_fit();
         _end = _begin;
     }
 
@@ -519,13 +581,13 @@ public:
         
         if (_end.cur != _end.first)
         {
-            alloc::destroy(_end.cur);
             --_end.cur;
+            alloc::destroy(_end.cur);
         }
-        else
+        else // 尾部缓冲区是空的，最后一个元素在前一个缓冲区的末尾
         {
-            alloc::destroy(_end.cur);
             --_end;
+            alloc::destroy(_end.cur);
             destroy_buffer(_end.node + 1, _end.node + 1);
         } 
     }
@@ -608,13 +670,16 @@ public:
 
 
     // 访问元素相关操作 
+    // 下标非负，直接算出缓冲区和缓冲区内的位置，不经过迭代器
     reference operator[](const size_type n){ 
         GHYSTL_DEBUG(n < size());
-        return _begin[n];
+        const difference_type off = static_cast<difference_type>(n) + (_begin.cur - _begin.first);
+        return _begin.node[index::node_offset(off)][index::slot(off)];
     }
     const_reference operator[](const size_type n) const { 
         GHYSTL_DEBUG(n < size());
-        return _begin[n];
+        const difference_type off = static_cast<difference_type>(n) + (_begin.cur - _begin.first);
+        return _begin.node[index::node_offset(off)][index::slot(off)];
     }
 
     reference at(const size_type n) { 
@@ -673,7 +738,8 @@ public:
             require_capacity(n, true);
             auto new_begin = _begin - n;
             GHYSTL::fill_n(new_begin, n, val);
-            begin = new_begin;
+            _begin = new_begin;
+            return _begin;
         }
         else if (pos.cur == _end.cur)
         {
@@ -681,10 +747,13 @@ public:
             auto new_end = _end + n;
             GHYSTL::fill_n(_end, n, val);
             _end = new_end;
+            return _end - n;
         }
         else
         {
+            const size_type elems_before = pos - _begin;
             fill_insert(pos, n, val);
+            return _begin + elems_before;
         }
     }
 
@@ -765,7 +834,7 @@ public:
     // 在尾部就地构建元素
     template<typename ... Args>
     void emplace_back(Args&& ...args){
-        if (_end.cur != _end.last - 1)
+        if (_end.last - _end.cur > 1) // 还没有 map 时两个都是空指针，差是 0
         {
             alloc::construct(_end.cur, std::forward<Args>(args)...);
             ++_end.cur;
@@ -780,23 +849,58 @@ public:
 
 private:
     /*----------------------------------------------- 底层空间构造和初始化 -----------------------------------------------------*/
+    // map 的分配器由元素的分配器 rebind 得到
+    map_alloc get_map_alloc() const { return map_alloc(this->get_alloc()); }
+
     map_type create_map(size_type size){
-        map_type mp = map_alloc::allocate(size);
+        map_type mp = get_map_alloc().allocate(size);
         for(size_type i = 0; i < size; ++i)
             *(mp + i) = nullptr;
         return mp;
     }
 
+    // 先用备用的缓冲区，没有了才向分配器申请
+    pointer get_buffer(){
+        for (size_type i = 0; i < DEQUE_SPARE_BLOCKS; ++i){
+            if (spare[i] != nullptr){
+                pointer p = spare[i];
+                spare[i] = nullptr;
+                return p;
+            }
+        }
+        return this->get_alloc().allocate(buffer_size);
+    }
+
+    // 备用的位置满了才真正释放
+    void put_buffer(pointer p){
+        for (size_type i = 0; i < DEQUE_SPARE_BLOCKS; ++i){
+            if (spare[i] == nullptr){
+                spare[i] = p;
+                return;
+            }
+        }
+        this->get_alloc().deallocate(p, buffer_size);
+    }
+
+    void release_spare(){
+        for (size_type i = 0; i < DEQUE_SPARE_BLOCKS; ++i){
+            if (spare[i] != nullptr){
+                this->get_alloc().deallocate(spare[i], buffer_size);
+                spare[i] = nullptr;
+            }
+        }
+    }
+
     void create_buffer(map_type nstart, map_type nfinish){
         map_type cur;
         try{
             for(cur = nstart; cur <= nfinish; ++cur)
-                *cur = alloc::allocate(buffer_size);
+                *cur = get_buffer();
         }catch(...){
             while (cur != nstart)
             {
                 --cur;
-                alloc::deallocate(*cur, buffer_size);
+                put_buffer(*cur);
                 *cur = nullptr;
             }
             throw;
@@ -804,9 +908,21 @@ private:
 
     }
 
+    // 析构 [first, last) 的元素，可以跨多个缓冲区
+    void destroy_elements(iterator first, iterator last){
+        if (first.node == last.node){
+            alloc::destroy(first.cur, last.cur);
+            return;
+        }
+        alloc::destroy(first.cur, first.last);
+        for (map_type cur = first.node + 1; cur < last.node; ++cur)
+            alloc::destroy(*cur, *cur + buffer_size);
+        alloc::destroy(last.first, last.cur);
+    }
+
     void destroy_buffer(map_type nstart, map_type nfinish){
         for(map_type n = nstart; n <= nfinish; ++n){
-            alloc::deallocate(*n, buffer_size);
+            put_buffer(*n);
             *n = nullptr;
         }
     }
@@ -832,7 +948,7 @@ private:
             create_buffer(nstart, nfinish);
         }
         catch(...){
-            map_alloc::deallocate(map, map_size);
+            get_map_alloc().deallocate(map, map_size);
             map = nullptr;
             map_size = 0;
             throw;
@@ -846,8 +962,8 @@ private:
 
     // 默认值初始化
     void copy_n_default(size_type n, const value_type& value){
-        map_init(n);
         if(n){
+            map_init(n);
             for(auto cur = _begin.node; cur < _end.node; ++cur){
                 alloc::copy_construct(*cur, *cur + buffer_size, value);
             }
@@ -858,9 +974,7 @@ private:
     // 使用 初始化列表 初始化
     template<typename IIter>
     void copy_init(IIter first, IIter last, GHYSTL::input_iterator_tag){
-        const size_type n = GHYSTL::distance(first, last);
-        map_init(n);
-        for(; first != last; ++first);
+        for(; first != last; ++first)
             emplace_back(*first);
     }
 
@@ -869,6 +983,7 @@ private:
     void copy_init(FIter first, FIter last, GHYSTL::forward_iterator_tag)
     {
         const size_type n = GHYSTL::distance(first, last);
+        if (n == 0) return;
         map_init(n);
         for (auto cur = _begin.node; cur < _end.node; ++cur)
         {
@@ -882,74 +997,68 @@ private:
 
     void require_capacity(size_type n, bool front)
     {
+        if (map == nullptr) // 第一次插入，先建 map 和一个缓冲区
+            map_init(0);
+
         if (front && (static_cast<size_type>(_begin.cur - _begin.first) < n)) // 在前面插入
         {
             const size_type need_buffer = (n - (_begin.cur - _begin.first)) / buffer_size + 1;
 
-            if (need_buffer > static_cast<size_type>(_begin.node - map)){
+            if (need_buffer > static_cast<size_type>(_begin.node - map))
                 reallocate_map_at_front(need_buffer);
-                return;
-            }
             create_buffer(_begin.node - need_buffer, _begin.node - 1);
         }
         else if (!front && (static_cast<size_type>(_end.last - _end.cur - 1) < n)) // 在后面插入
         {
             const size_type need_buffer = (n - (_end.last - _end.cur - 1)) / buffer_size + 1;
 
-            if (need_buffer > static_cast<size_type>((map + map_size) - _end.node - 1)){
+            if (need_buffer > static_cast<size_type>((map + map_size) - _end.node - 1))
                 reallocate_map_at_back(need_buffer);
-                return;
-            }
             create_buffer(_end.node + 1, _end.node + need_buffer);
         }
     }
     
-    void reallocate_map_at_front(size_type need_buffer)
-    {
-        //开辟新的空间
-        const size_type new_map_size = GHYSTL::max(map_size << 1, map_size + need_buffer + DEQUE_MAP_INIT_SIZE);
-        map_type new_map = create_map(new_map_size);
-        const size_type old_buffer = _end.node - _begin.node + 1;
-        const size_type new_buffer = old_buffer + need_buffer;
+    // 让 map 头部至少空出 need_buffer 个位置，缓冲区由调用者创建
+    void reallocate_map_at_front(size_type need_buffer) { reallocate_map(need_buffer, true); }
 
-        // 新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
-        auto new_begin = new_map + (new_map_size - new_buffer) / 2;
-        auto new_mid = new_begin + need_buffer;
-        auto new_end = new_mid + old_buffer;
-        create_buffer(new_begin, new_mid - 1);
-        for (auto begin_1 = new_mid, begin_2 = _begin.node; begin_1 != new_end; ++begin_1, ++begin_2)
-            *begin_1 = *begin_2;
+    // 让 map 尾部至少空出 need_buffer 个位置，缓冲区由调用者创建
+    void reallocate_map_at_back(size_type need_buffer) { reallocate_map(need_buffer, false); }
 
-        // 释放旧的 deque 内存
-        map_alloc::deallocate(map, map_size);
-        map = new_map;
-        map_size = new_map_size;
-        _begin = iterator(*new_mid + (_begin.cur - _begin.first), new_mid);
-        _end = iterator(*(new_end - 1) + (_end.cur - _end.first), new_end - 1);
-    }
-
-    void reallocate_map_at_back(size_type need_buffer)
+    // map 的空位超过一半时只把已用的部分挪到中间(队列一头进一头出时就是这种情况)，
+    // 否则开辟更大的 map
+    void reallocate_map(size_type need_buffer, bool front)
     {
-        const size_type new_map_size = GHYSTL::max(map_size << 1, map_size + need_buffer + DEQUE_MAP_INIT_SIZE);
-        map_type new_map = create_map(new_map_size);
         const size_type old_buffer = _end.node - _begin.node + 1;
         const size_type new_buffer = old_buffer + need_buffer;
+        const difference_type begin_off = _begin.cur - _begin.first;
+        const difference_type end_off = _end.cur - _end.first;
 
-        // 另新的 map 中的指针指向原来的 buffer，并开辟新的 buffer
-        auto new_begin = new_map + ((new_map_size - new_buffer) / 2);
-        auto new_mid = new_begin + old_buffer;
-        auto new_end = new_mid + need_buffer;
-        for (auto begin_1 = new_begin, begin_2 = _begin.node; begin_1 != new_mid; ++begin_1, ++begin_2)
-            *begin_1 = *begin_2;
-
-        create_buffer(new_mid, new_end - 1);
+        map_type new_start; // 原来第一个缓冲区的新位置
+        if (map_size > 2 * new_buffer)
+        {
+            new_start = map + (map_size - new_buffer) / 2 + (front ? need_buffer : 0);
+            std::memmove(new_start, _begin.node, old_buffer * sizeof(pointer));
+            for (map_type cur = map; cur < new_start; ++cur)
+                *cur = nullptr;
+            for (map_type cur = new_start + old_buffer; cur < map + map_size; ++cur)
+                *cur = nullptr;
+        }
+        else
+        {
+            const size_type new_map_size = GHYSTL::max(map_size << 1, map_size + need_buffer + DEQUE_MAP_INIT_SIZE);
+            map_type new_map = create_map(new_map_size);
+            new_start = new_map + (new_map_size - new_buffer) / 2 + (front ? need_buffer : 0);
+            std::memcpy(new_start, _begin.node, old_buffer * sizeof(pointer));
+
+            get_map_alloc().deallocate(map, map_size);
+            map = new_map;
+            map_size = new_map_size;
+        }
 
-        // 更新数据
-        map_alloc::deallocate(map, map_size);
-        map = new_map;
-        map_size = new_map_size;
-        _begin = iterator(*new_begin + (_begin.cur - _begin.first), new_begin);
-        _end = iterator(*(new_mid - 1) + (_end.cur - _end.first), new_mid - 1);
+        _begin.set_node(new_start);
+        _begin.cur = _begin.first + begin_off;
+        _end.set_node(new_start + old_buffer - 1);
+        _end.cur = _end.first + end_off;
     }
 
     template <class... Args>
@@ -982,15 +1091,15 @@ private:
     }
 };
 
-template<typename value_type, typename alloc, typename NoType>
-inline void swap(GHYSTL::deque<value_type, alloc, NoType> & left,
-                GHYSTL::deque<value_type, alloc, NoType> & right) noexcept {
+template<typename value_type, typename alloc, size_t BufSize>
+inline void swap(GHYSTL::deque<value_type, alloc, BufSize> & left,
+                GHYSTL::deque<value_type, alloc, BufSize> & right) noexcept {
     left.swap(right);
 }
 
-template<typename value_type, typename alloc, typename NoType>
-typename deque<value_type, alloc, NoType>::self& 
-    deque<value_type, alloc, NoType>::operator=(const self& rhs){
+template<typename value_type, typename alloc, size_t BufSize>
+typename deque<value_type, alloc, BufSize>::self& 
+    deque<value_type, alloc, BufSize>::operator=(const self& rhs){
              if (this != &rhs){
                 const auto len = size();
 
@@ -1006,18 +1115,19 @@ typename deque<value_type, alloc, NoType>::self&
             return *this;
 }
 
-template<typename value_type, typename alloc, typename NoType>
-typename deque<value_type, alloc, NoType>::self& 
-    deque<value_type, alloc, NoType>::operator=(self&& x){
-            clear();
-            _begin = std::move(x._begin);
-            _end = std::move(x._end);
-            x.map = nullptr;
-            x.map_size = 0;
+// 元素清空后和 x 交换，x 拿走原来的空间
+template<typename value_type, typename alloc, size_t BufSize>
+typename deque<value_type, alloc, BufSize>::self& 
+    deque<value_type, alloc, BufSize>::operator=(self&& x){
+            if (this != &x){
+                clear();
+                swap(x);
+            }
+            return *this;
 }
 
-template<typename value_type, typename alloc, typename NoType>
-void deque<value_type, alloc, NoType>::
+template<typename value_type, typename alloc, size_t BufSize>
+void deque<value_type, alloc, BufSize>::
 fill_insert(iterator position, size_type n, const value_type& value){
         const size_type elems_before = position - _begin;
         const size_type len = size();
@@ -1038,7 +1148,7 @@ fill_insert(iterator position, size_type n, const value_type& value){
                     GHYSTL::copy(_begin, begin_n, new_begin);
                     _begin = new_begin;
                     GHYSTL::copy(begin_n, position, old_begin);
-                    GHYSTL::fill_n(position - n, position, value_copy);
+                    GHYSTL::fill(position - n, position, value_copy);
                 } 
                 else { // 插入点前的元素 比 n 小
                     GHYSTL::fill(GHYSTL::copy(_begin, position, new_begin), _begin, value_copy);
@@ -1073,7 +1183,7 @@ fill_insert(iterator position, size_type n, const value_type& value){
                     GHYSTL::fill(position, position + n, value_copy);
                 }
                 else {
-                    GHYSTL::fill_n(_end, position + n, value_copy);
+                    GHYSTL::fill(_end, position + n, value_copy);
                     GHYSTL::copy(position, _end, position + n);
                     _end = new_end;
                     GHYSTL::fill(position, old_end, value_copy);
@@ -1089,8 +1199,8 @@ fill_insert(iterator position, size_type n, const value_type& value){
     }
 
 // 在头部插入元素
-template <typename value_type, typename alloc, typename NoType>
-void deque<value_type, alloc, NoType>::
+template <typename value_type, typename alloc, size_t BufSize>
+void deque<value_type, alloc, BufSize>::
 push_front(const value_type& value){
   if (_begin.cur != _begin.first) { // 有空间
     alloc::construct(_begin.cur - 1, value);
@@ -1112,11 +1222,11 @@ push_front(const value_type& value){
 }
 
 // 在尾部插入元素
-template <typename value_type, typename alloc, typename NoType>
-void deque<value_type, alloc, NoType>::
+template <typename value_type, typename alloc, size_t BufSize>
+void deque<value_type, alloc, BufSize>::
 push_back(const value_type& value)
 {
-  if (_end.cur != _end.last - 1){
+  if (_end.last - _end.cur > 1){ // 还没有 map 时两个都是空指针，差是 0
     alloc::construct(_end.cur, value);
     ++_end.cur;
   }
@@ -1127,9 +1237,9 @@ push_back(const value_type& value)
   }
 }
 
-template <typename value_type, typename alloc, typename NoType>
+template <typename value_type, typename alloc, size_t BufSize>
 template <class FIter>
-void deque<value_type, alloc, NoType>::
+void deque<value_type, alloc, BufSize>::
 copy_insert(iterator position, FIter first, FIter last, size_type n)
 {
   const size_type elems_before = position - _begin;
@@ -1202,9 +1312,9 @@ copy_insert(iterator position, FIter first, FIter last, size_type n)
   }
 }
 
-template <typename value_type, typename alloc, typename NoType>
+template <typename value_type, typename alloc, size_t BufSize>
 template <class IIter>
-void deque<value_type, alloc, NoType>::
+void deque<value_type, alloc, BufSize>::
 insert_dispatch(iterator position, IIter first, IIter last, GHYSTL::input_iterator_tag)
 {
     if (last <= first)  return;
@@ -1226,9 +1336,9 @@ insert_dispatch(iterator position, IIter first, IIter last, GHYSTL::input_iterat
     }
 }
 
-template <typename value_type, typename alloc, typename NoType>
+template <typename value_type, typename alloc, size_t BufSize>
 template <class FIter>
-void deque<value_type, alloc, NoType>::
+void deque<value_type, alloc, BufSize>::
 insert_dispatch(iterator position, FIter first, FIter last, GHYSTL::forward_iterator_tag)
 {
   if (last <= first)  return;
@@ -1269,41 +1379,41 @@ insert_dispatch(iterator position, FIter first, FIter last, GHYSTL::forward_iter
 }
 
 /**-------------------------------------- 重写的比较运算符 ---------------------------------------------------------*/
-template <typename value_type, typename alloc, typename NoType>
-inline bool operator==(const GHYSTL::deque<value_type, alloc, NoType> &left,
-                       const GHYSTL::deque<value_type, alloc, NoType> &right){
+template <typename value_type, typename alloc, size_t BufSize>
+inline bool operator==(const GHYSTL::deque<value_type, alloc, BufSize> &left,
+                       const GHYSTL::deque<value_type, alloc, BufSize> &right){
     return (left.size() == right.size() &&
           GHYSTL::equal(left.begin(), left.end(), right.begin(), right.end()));
 }
 
-template <typename value_type, typename alloc, typename NoType>
-inline bool operator!=(const GHYSTL::deque<value_type, alloc, NoType> &left,
-                       const GHYSTL::deque<value_type, alloc, NoType> &right){
+template <typename value_type, typename alloc, size_t BufSize>
+inline bool operator!=(const GHYSTL::deque<value_type, alloc, BufSize> &left,
+                       const GHYSTL::deque<value_type, alloc, BufSize> &right){
     return !(left == right);
 }
 
-template <typename value_type, typename alloc, typename NoType>
-inline bool operator<(const GHYSTL::deque<value_type, alloc, NoType> &left,
-                      const GHYSTL::deque<value_type, alloc, NoType> &right){
+template <typename value_type, typename alloc, size_t BufSize>
+inline bool operator<(const GHYSTL::deque<value_type, alloc, BufSize> &left,
+                      const GHYSTL::deque<value_type, alloc, BufSize> &right){
   return GHYSTL::lexicographical_compare(left.begin(), left.end(), right.begin(),
                                       right.end());
 }
 
-template <typename value_type, typename alloc, typename NoType>
-inline bool operator<=(const GHYSTL::deque<value_type, alloc, NoType> &left,
-                       const GHYSTL::deque<value_type, alloc, NoType> &right){
+template <typename value_type, typename alloc, size_t BufSize>
+inline bool operator<=(const GHYSTL::deque<value_type, alloc, BufSize> &left,
+                       const GHYSTL::deque<value_type, alloc, BufSize> &right){
   return !(right < left);
 }
 
-template <typename value_type, typename alloc, typename NoType>
-inline bool operator>(const GHYSTL::deque<value_type, alloc, NoType> &left,
-                      const GHYSTL::deque<value_type, alloc, NoType> &right){
+template <typename value_type, typename alloc, size_t BufSize>
+inline bool operator>(const GHYSTL::deque<value_type, alloc, BufSize> &left,
+                      const GHYSTL::deque<value_type, alloc, BufSize> &right){
   return right < left;
 }
 
-template <typename value_type, typename alloc, typename NoType>
-inline bool operator>=(const GHYSTL::deque<value_type, alloc, NoType> &left,
-                       const GHYSTL::deque<value_type, alloc, NoType> &right){
+template <typename value_type, typename alloc, size_t BufSize>
+inline bool operator>=(const GHYSTL::deque<value_type, alloc, BufSize> &left,
+                       const GHYSTL::deque<value_type, alloc, BufSize> &right){
   return !(left < right);
 }
 
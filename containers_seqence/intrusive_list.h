@@ -0,0 +1,377 @@
+/**
+ * @file intrusive_list.h
+ * @brief 侵入式链表：链接指针放在元素自己身上，链表不分配任何内存
+ *
+ * @version 1.0
+ *
+ */
+
+#pragma once
+#ifndef _INTRUSIVE_LIST_H_
+#define _INTRUSIVE_LIST_H_
+
+#include "list.h"
+
+namespace GHYSTL{
+
+/************************************************ 链接钩子 ************************************************************/
+
+// 元素里放一个 list_hook 成员，intrusive_list<T, &T::hook> 就通过它把元素串起来
+// 和 list_base_node 一样是 prev、next 两个指针，链表也是带哨兵的双向环
+// 一个元素想同时在几条链表里，就放几个 hook
+struct list_hook{
+    list_hook* prev;
+    list_hook* next;
+
+    list_hook() : prev(nullptr), next(nullptr) {}
+
+    // 拷贝元素时不拷贝链接关系
+    list_hook(const list_hook&) : prev(nullptr), next(nullptr) {}
+    list_hook& operator=(const list_hook&) { return *this; }
+
+    bool is_linked() const { return next != nullptr; }
+};
+
+
+/************************************************ 迭代器 ************************************************************/
+
+// 从 hook 的地址算出所在元素的地址
+template<typename T, list_hook T::*Hook>
+struct intrusive_list_traits{
+    static size_t offset(){
+        return reinterpret_cast<size_t>(&(reinterpret_cast<T*>(0)->*Hook));
+    }
+
+    static T* to_value(list_hook* h){
+        return reinterpret_cast<T*>(reinterpret_cast<char*>(h) - offset());
+    }
+
+    static list_hook* to_hook(T& val) { return &(val.*Hook); }
+};
+
+
+template<typename T, list_hook T::*Hook>
+class intrusive_list_const_iterator
+{
+public:
+    template<typename U, list_hook U::*H>
+    friend class intrusive_list;
+
+    typedef GHYSTL::bidirectional_iterator_tag          iterator_category;
+    typedef T                                           value_type;
+    typedef const value_type*                           pointer;
+    typedef const value_type&                           reference;
+    typedef ptrdiff_t                                   difference_type;
+
+    typedef intrusive_list_const_iterator<T, Hook>      self;
+    typedef intrusive_list_traits<T, Hook>              traits;
+    typedef list_hook*                                  link_type;
+    typedef size_t                                      size_type;
+
+protected:
+    link_type node;
+
+public:
+    intrusive_list_const_iterator(link_type node = nullptr) : node(node) {}
+
+    bool operator==(const self& x) const { return node == x.node; }
+    bool operator!=(const self& x) const { return !operator==(x); }
+
+    reference operator*() const { return *traits::to_value(node); }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++(){
+        node = node->next;
+        return *this;
+    }
+
+    self operator++(int){
+        self ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    self& operator--(){
+        node = node->prev;
+        return *this;
+    }
+
+    self operator--(int){
+        self ret = *this;
+        --*this;
+        return ret;
+    }
+};
+
+
+template<typename T, list_hook T::*Hook>
+class intrusive_list_iterator : public intrusive_list_const_iterator<T, Hook>
+{
+public:
+    typedef GHYSTL::bidirectional_iterator_tag              iterator_category;
+    typedef T                                               value_type;
+    typedef value_type*                                     pointer;
+    typedef value_type&                                     reference;
+    typedef ptrdiff_t                                       difference_type;
+
+    typedef intrusive_list_iterator<T, Hook>                self;
+    typedef intrusive_list_const_iterator<T, Hook>          iterator_base;
+    typedef intrusive_list_traits<T, Hook>                  traits;
+    typedef list_hook*                                      link_type;
+    typedef size_t                                          size_type;
+
+    intrusive_list_iterator(link_type node = nullptr) : iterator_base(node) {}
+
+    bool operator==(const self& x) const { return this->node == x.node; }
+    bool operator!=(const self& x) const { return !(operator==(x)); }
+
+    reference operator*() const { return *traits::to_value(this->node); }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++(){
+        this->node = this->node->next;
+        return *this;
+    }
+
+    self operator++(int){
+        self ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    self& operator--(){
+        this->node = this->node->prev;
+        return *this;
+    }
+
+    self operator--(int){
+        self ret = *this;
+        --*this;
+        return ret;
+    }
+};
+
+
+/************************************************ 侵入式链表 intrusive_list ************************************************************/
+
+// 元素的生命周期由使用者管理，链表只负责链接和断开
+// 元素被销毁前要先从链表里拿掉；链表析构或 clear 时把所有元素的 hook 清空，不销毁元素
+// 一个元素同一时间只能通过同一个 hook 挂在一条链表上
+template<typename T, list_hook T::*Hook>
+class intrusive_list
+{
+public:
+    typedef T                       value_type;
+    typedef value_type*             pointer;
+    typedef const value_type*       const_pointer;
+    typedef value_type&             reference;
+    typedef const value_type&       const_reference;
+    typedef size_t                  size_type;
+    typedef ptrdiff_t               difference_type;
+
+    typedef intrusive_list<T, Hook>                         self;
+    typedef intrusive_list_traits<T, Hook>                  traits;
+    typedef list_hook*                                      link_type;
+
+    typedef intrusive_list_iterator<T, Hook>                iterator;
+    typedef intrusive_list_const_iterator<T, Hook>          const_iterator;
+    typedef GHYSTL::reverse_iterator<iterator>              reverse_iterator;
+    typedef GHYSTL::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+private:
+    list_hook root; // 哨兵，就在链表对象里
+    size_type node_count;
+
+public:
+    /*-------------------------------------------- 构造函数 ------------------------------------------------*/
+    intrusive_list() { empty_init(); }
+
+    intrusive_list(const self&) = delete;
+    self& operator=(const self&) = delete;
+
+    // 元素挂到新的哨兵上，x 变成空链表
+    intrusive_list(self&& x) noexcept {
+        empty_init();
+        splice(end(), x);
+    }
+
+    self& operator=(self&& x) noexcept {
+        if(this != &x){
+            clear();
+            splice(end(), x);
+        }
+        return *this;
+    }
+
+    ~intrusive_list() { clear(); }
+
+public:
+    /*-------------------------------------------- 访问元素 ------------------------------------------------*/
+    iterator begin() { return iterator(root.next); }
+    const_iterator begin() const { return const_iterator(root.next); }
+    const_iterator cbegin() const { return begin(); }
+
+    // 哨兵在 const 对象里也要当作可以修改的结点
+    iterator end() { return iterator(&root); }
+    const_iterator end() const { return const_iterator(const_cast<link_type>(&root)); }
+    const_iterator cend() const { return end(); }
+
+    reverse_iterator rbegin() { return reverse_iterator(end()); }
+    const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+    reverse_iterator rend() { return reverse_iterator(begin()); }
+    const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+    reference back() { return *(--end()); }
+    const_reference back() const { return *(--end()); }
+
+    size_type size() const { return node_count; }
+    bool empty() const { return node_count == 0; }
+
+    // 已经在链表里的元素转成迭代器，O(1)
+    iterator iterator_to(reference val) { return iterator(traits::to_hook(val)); }
+    const_iterator iterator_to(const_reference val) const {
+        return const_iterator(traits::to_hook(const_cast<reference>(val)));
+    }
+
+public:
+    /*-------------------------------------------- 插入删除 ------------------------------------------------*/
+    void push_front(reference val) { insert(begin(), val); }
+    void push_back(reference val) { insert(end(), val); }
+
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(--end()); }
+
+    // val 插到 pos 之前，val 不能已经在某条链表里
+    iterator insert(const_iterator pos, reference val){
+        link_type h = traits::to_hook(val);
+        GHYSTL_DEBUG(!h->is_linked());
+        link_type next = pos.node;
+        h->next = next;
+        h->prev = next->prev;
+        next->prev->next = h;
+        next->prev = h;
+        ++node_count;
+        return iterator(h);
+    }
+
+    template<typename Iter>
+    void insert(const_iterator pos, Iter first, Iter last){
+        for(; first != last; ++first)
+            insert(pos, *first);
+    }
+
+    iterator erase(const_iterator pos){
+        GHYSTL_DEBUG(pos != cend());
+        link_type next = pos.node->next;
+        unlink(pos.node);
+        --node_count;
+        return iterator(next);
+    }
+
+    iterator erase(const_iterator first, const_iterator last){
+        while(first != last)
+            first = erase(first);
+        return iterator(last.node);
+    }
+
+    // 按引用删除，不用先找到迭代器
+    void erase(reference val) { erase(iterator_to(val)); }
+
+    void clear(){
+        link_type cur = root.next;
+        while(cur != &root){
+            link_type next = cur->next;
+            cur->prev = cur->next = nullptr;
+            cur = next;
+        }
+        empty_init();
+    }
+
+    template<typename Pred>
+    void remove_if(const Pred& pred){
+        for(iterator bg = begin(); bg != end(); )
+            if(pred(*bg))
+                bg = erase(bg);
+            else
+                ++bg;
+    }
+
+    void swap(self& x) noexcept {
+        self tmp(std::move(x));
+        x = std::move(*this);
+        *this = std::move(tmp);
+    }
+
+    void reverse(){
+        link_type cur = &root;
+        do{
+            GHYSTL::swap(cur->prev, cur->next);
+            cur = cur->prev;
+        }while(cur != &root);
+    }
+
+public:
+    /*-------------------------------------------- splice ------------------------------------------------*/
+    // 把 x 的全部元素移到 pos 之前
+    void splice(const_iterator pos, self& x){
+        if(x.empty()) return;
+        transfer(pos.node, x.root.next, &x.root);
+        node_count += x.node_count;
+        x.node_count = 0;
+    }
+
+    // 把 x 中的 it 移到 pos 之前，x 可以就是 *this
+    void splice(const_iterator pos, self& x, const_iterator it){
+        link_type next = it.node->next;
+        if(pos.node == it.node || pos.node == next) return;
+        transfer(pos.node, it.node, next);
+        ++node_count;
+        --x.node_count;
+    }
+
+    // 把 x 中的 [first, last) 移到 pos 之前，pos 不能在 [first, last) 里
+    // x 是别的链表时要数一遍区间长度
+    void splice(const_iterator pos, self& x, const_iterator first, const_iterator last){
+        if(first == last) return;
+        if(this != &x){
+            const size_type n = GHYSTL::distance(first, last);
+            node_count += n;
+            x.node_count -= n;
+        }
+        transfer(pos.node, first.node, last.node);
+    }
+
+private:
+    void empty_init(){
+        root.prev = root.next = &root;
+        node_count = 0;
+    }
+
+    static void unlink(link_type h){
+        h->prev->next = h->next;
+        h->next->prev = h->prev;
+        h->prev = h->next = nullptr;
+    }
+
+    // [first, last) 移到 pos 之前，不改计数
+    static void transfer(link_type pos, link_type first, link_type last){
+        if(pos == last) return;
+        link_type tail = last->prev;
+        first->prev->next = last;
+        last->prev = first->prev;
+
+        tail->next = pos;
+        first->prev = pos->prev;
+        pos->prev->next = first;
+        pos->prev = tail;
+    }
+};
+
+template<typename T, list_hook T::*Hook>
+inline void swap(intrusive_list<T, Hook>& a, intrusive_list<T, Hook>& b) noexcept { a.swap(b); }
+
+}
+
+#endif
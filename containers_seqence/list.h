@@ -178,7 +178,7 @@ public:
 
 /************************************************ 链表 list ************************************************************/
 template <typename value_type_, typename Alloc = GHYSTL::allocator<value_type_>>
-class list
+class list : private GHYSTL::alloc_holder<typename GHYSTL::node_allocator<Alloc, list_node<value_type_>>::type>
 {
 public:
     typedef value_type_             value_type;
@@ -194,42 +194,54 @@ public:
 
     typedef Alloc           allocator_type;
     typedef Alloc           data_alloc;
-    typedef typename allocator_type::template rebind<list_node<value_type>>::other              node_alloc;
+    typedef typename GHYSTL::node_allocator<allocator_type, list_node<value_type>>::type        node_alloc;
     typedef typename allocator_type::template rebind<list_base_node<value_type>>::other         base_alloc;
+    typedef GHYSTL::alloc_holder<node_alloc>                                                    holder_type;
 
     typedef list_iterator<value_type>                       iterator;
     typedef list_const_iterator<value_type>                 const_iterator;
     typedef GHYSTL::reverse_iterator<iterator>              reverse_iterator;
     typedef GHYSTL::reverse_iterator<const_iterator>        const_reverse_iterator;
 
-    allocator_type get_allocator() const { return allocator_type(); }
+    allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
 
 private:
   link_type node; // 类内可以访问私有变量
+  size_type node_count; // 元素个数，size() 直接返回，插入、删除、splice、merge 时维护
 
 public:
     /*-------------------------------------------- 构造函数 ------------------------------------------------*/
     list() { empty_init(); }
 
+    // 使用指定的分配器实例，结点都从这个实例(rebind 成结点类型)上分配
+    explicit list(const allocator_type& a) : holder_type(node_alloc(a)) { empty_init(); }
+
     template<typename Iter,
                 typename = typename GHYSTL::enable_if<is_iterator<Iter>::value, void>::type>
-    list(Iter first, Iter last) : list(){
+    list(Iter first, Iter last, const allocator_type& a = allocator_type()) : list(a){
         assign(first, last);
     }
 
-    explicit list(const size_type n) : list() { resize(n); }
+    explicit list(const size_type n, const allocator_type& a = allocator_type()) : list(a) { resize(n); }
 
-    list(const size_type n, const value_type& val) : list() {
+    list(const size_type n, const value_type& val, const allocator_type& a = allocator_type()) : list(a) {
         insert(begin(), n, val);
     }
 
-    list(std::initializer_list<value_type>& lst) : list() {
+    list(std::initializer_list<value_type>& lst, const allocator_type& a = allocator_type()) : list(a) {
         assign(lst.begin(), lst.end());
     }
 
-    list(const self& x) : list() { insert(begin(), x.begin(), x.end()); }
+    list(const self& x) : holder_type(x.get_alloc()) { 
+        empty_init();
+        insert(begin(), x.begin(), x.end()); 
+    }
 
-    list(self&& x) : list() { GHYSTL::swap(node, x.node); } // 通过调用默认构造函数，创建空结点，然后交换
+    list(self&& x) : holder_type(x.get_alloc()) { // 创建空结点，然后交换
+        empty_init();
+        GHYSTL::swap(node, x.node); 
+        GHYSTL::swap(node_count, x.node_count);
+    }
 
     self& operator=(const self& x){
         if(this != &x){
@@ -252,7 +264,7 @@ public:
     ~list(){
         if(node){
             clear();
-            base_alloc::deallocate(node);
+            this->get_alloc().deallocate(node);
             node = nullptr;
         }
     }
@@ -260,7 +272,11 @@ public:
 public:
     /*-------------------------------------------- 常规操作函数 ------------------------------------------------*/
 
-    void swap(self& x) noexcept { GHYSTL::swap(node, x.node); }
+    void swap(self& x) noexcept { 
+        GHYSTL::swap(node, x.node); 
+        GHYSTL::swap(node_count, x.node_count);
+        this->swap_alloc(x);
+    }
 
     iterator erase(const_iterator pos){
         GHYSTL_DEBUG(pos != cend());
@@ -291,7 +307,7 @@ public:
     void resize(const size_type new_size, const value_type& val){
         size_type n = size();
         if(n < new_size){
-            insert(end(), n - new_size, val);
+            insert(end(), new_size - n, val);
         }
         else{
             for(; n != new_size; --n)
@@ -335,10 +351,12 @@ public:
 
     void sort() { sort(GHYSTL::less<value_type>()); }
     
+    // 稳定的归并排序，只改结点之间的链接，不重新分配结点，迭代器仍然指向原来的元素
+    // 结点少时在 next 指针上自底向上归并；结点多时先把结点地址收集到数组里，
+    // 在数组上归并，最后按顺序重新链接一遍，归并时顺序访问的是数组而不是在堆上追指针
+    // cmp 抛出异常时所有结点仍然留在 list 里，顺序不确定
     template<typename Comp>
-    void sort(const Comp& cmp){
-        merge_sort(begin(), end(), size(), cmp);
-    }
+    void sort(const Comp& cmp);
    
 public:
     /*-------------------------------------------- 插入删除 push、pop、emplace ------------------------------------------------*/
@@ -385,7 +403,7 @@ public:
         return emplace(pos, std::move(val));
     }
 
-    void insert(const_iterator pos, const size_type n, const value_type& val){
+    iterator insert(const_iterator pos, const size_type n, const value_type& val){
         const_iterator prev = pos;
         if(prev == cbegin()){
             insert_n(pos, n, val);
@@ -414,7 +432,7 @@ public:
     }
 
     iterator insert(const_iterator pos, const std::initializer_list<value_type>& lst){
-        return insert(pos, lst.begin(), lst.en());
+        return insert(pos, lst.begin(), lst.end());
     }
 
 
@@ -435,22 +453,47 @@ public:
         iterator ed = end();
 
         for(; bg != ed && n != 0; --n, ++bg)
-            resueNode(bg, val);
-        for(; n != 0; val)
+            reuseNode(bg, val);
+        for(; n != 0; --n)
             insert_imple(bg, val);
         
-        earse(bg, ed);
+        erase(bg, ed);
     }
 
     /*--------------------------------------------  链接两个 list splice ------------------------------------------------*/
+    // 把 x 的所有结点接到 pos 前面
     void splice(const_iterator pos, self& x){
-        if(x.empty())
+        if(this != &x && !x.empty()){
             transfer(pos, x.begin(), x.end());
+            node_count += x.node_count;
+            x.node_count = 0;
+        }
     }
 
     void splice(const_iterator pos, self&& x) { splice(pos, (self&) x); }
 
+    // 把 x 中的 tar 接到 pos 前面
+    void splice(const_iterator pos, self& x, const_iterator tar){
+        const_iterator last = tar;
+        if(pos != tar && pos != ++last){
+            transfer(pos, tar, last);
+            ++node_count;
+            --x.node_count;
+        }
+    }
+
+    // 把 x 中的 [first, last) 接到 pos 前面，来自别的 list 时只数一次个数
+    void splice(const_iterator pos, self& x, const_iterator first, const_iterator last){
+        if(first == last || first == pos) return;
+        if(this != &x){
+            const size_type n = GHYSTL::distance(first, last);
+            node_count += n;
+            x.node_count -= n;
+        }
+        transfer(pos, first, last);
+    }
 
+    // 下面两个只在同一个 list 内移动结点，个数不变
     void splice(const_iterator pos, const_iterator tar){
         const_iterator last = tar;
         if(pos != tar)
@@ -479,8 +522,8 @@ public:
 public:
 /*-------------------------------------------- 迭代器相关操作 ------------------------------------------------*/
 
-bool empty() const { return node->next == node; }
-size_type size() const { return GHYSTL::distance(begin(), end()); }
+bool empty() const { return node_count == 0; }
+size_type size() const { return node_count; }
 
 // 获取头尾迭代器
 iterator begin() noexcept { return iterator(node->next); }
@@ -519,13 +562,13 @@ iterator make_iter(const_iterator iter) const {
 
 template<typename ... types>
 link_type create_node(types && ... args){
-    link_type p = node_alloc::allocate();
+    link_type p = this->get_alloc().allocate();
 
     try{
         data_alloc::construct(std::addressof(p->data), std::forward<types>(args)...);
     }
     catch(...){
-        node_alloc::deallocate(p);
+        this->get_alloc().deallocate(p);
         throw;
     }
 
@@ -534,7 +577,7 @@ link_type create_node(types && ... args){
 
 void destros_and_free_node(link_type ptr){
     node_alloc::destroy(&(ptr->data));
-    node_alloc::deallocate(ptr);
+    this->get_alloc().deallocate(ptr);
 }
 
 void transfer(const_iterator pos, const_iterator first, const_iterator last){
@@ -562,6 +605,7 @@ void insert_imple(const_iterator pos, types && ... args){
     tmp->next = cur;
     tmp->prev = cur->prev;
     cur->prev = tmp;
+    ++node_count;
 }
 
 template<typename Iter>
@@ -570,11 +614,34 @@ void insert_range(const_iterator pos, Iter first, Iter last, GHYSTL::input_itera
         insert_imple(pos, *first);
 }
 
+// 元素个数事先知道，结点整批向分配器申请，再逐个构造、挂到 pos 前面
 template<typename Iter>
-void insert_range(const_iterator pos, Iter first, Iter last, GHYSTL::random_access_iterator_tag){
-    size_type num = last - first;
-    for(; num != 0; --num, ++first)
-        insert_imple(pos, *first);
+void insert_range(const_iterator pos, Iter first, Iter last, GHYSTL::forward_iterator_tag){
+    link_type chain = GHYSTL::allocate_nodes(this->get_alloc(), GHYSTL::distance(first, last));
+    link_type cur = pos.get_node();
+
+    try{
+        for(; first != last; ++first){
+            link_type tmp = chain;
+            chain = GHYSTL::batch_next(chain);
+            try{
+                data_alloc::construct(std::addressof(tmp->data), *first);
+            }
+            catch(...){
+                this->get_alloc().deallocate(tmp);
+                throw;
+            }
+            cur->prev->next = tmp;
+            tmp->next = cur;
+            tmp->prev = cur->prev;
+            cur->prev = tmp;
+            ++node_count;
+        }
+    }
+    catch(...){
+        GHYSTL::deallocate_nodes(this->get_alloc(), chain);
+        throw;
+    }
 }
 
 void erase_imple(const_iterator pos){
@@ -583,6 +650,7 @@ void erase_imple(const_iterator pos){
 
     prev_node->next = next_node;
     next_node->prev = prev_node;
+    --node_count;
 
     destros_and_free_node(pos.get_node());
 }
@@ -594,8 +662,7 @@ void assign_imple(Iter first, Iter last, GHYSTL::input_iterator_tag){
 
     for(; bg != ed && first != last; ++first, ++bg)
         reuseNode(bg, *first);
-    for(; first != last; ++first) // 第二个链表长
-        insert_imple(bg, *first);
+    insert_range(bg, first, last, GHYSTL::iterator_category(first)); // 第二个链表长
     
     erase(bg, ed);
 }
@@ -608,8 +675,7 @@ void assign_imple(Iter first, Iter last, GHYSTL::random_access_iterator_tag){
 
     for(; bg != ed && n != 0; --n, ++first, ++bg)
         this->reuseNode(bg, *first);
-    for(; n != 0; --n, ++first)
-        insert_imple(bg, *first);
+    insert_range(bg, first, last, GHYSTL::iterator_category(first));
 
     erase(bg, ed);
 }
@@ -621,91 +687,265 @@ void reuseNode(const_iterator pos, type && val){
 }
 
 void empty_init(){
-    node = (link_type)base_alloc::allocate();
+    node = this->get_alloc().allocate(); // 哨兵结点也要按完整的 list_node 分配，下面会在 data 上构造
     data_alloc::construct(std::addressof(node->data));
     node->next = node;
     node->prev = node;
+    node_count = 0;
 }
 
-template<typename Compare = GHYSTL::less<value_type>>
-iterator merge_sort(iterator first, iterator last, size_type len, Compare& cmp = Compare());
+enum { _SORT_GATHER = 65536 }; // 至少这么多个结点时 sort 收集结点地址到数组里排序
+
+template<typename Comp>
+static void merge_chain(link_type& dest, link_type src, const Comp& cmp);
+
+template<typename Comp>
+static void sort_chain(link_type& chain, const Comp& cmp);
+
+template<typename Comp>
+static void sort_gather(link_type& chain, size_type n, const Comp& cmp);
+
+template<typename Comp>
+static void sort_runs(link_type* buf, size_type n, const Comp& cmp);
+
+static link_type join_chains(link_type* chains, size_type n, link_type rest);
+
+static link_type link_array(link_type* buf, size_type n);
+
+void relink(link_type chain);
 
 }; // end of class
 
 template <typename value_type, typename alloc>
 template<typename Compare>
 void list<value_type, alloc>::merge(self& lst, const Compare& cmp){
+    if(this == &lst) return;
+
     iterator first1 = begin();
     iterator last1  = end();
     iterator first2 = lst.begin();
     iterator last2  = lst.end();
 
-    if(first1 == last1)
-        splice(end(), lst);
-    else if(first2 == last2)
-        return;
-    else  
-        for(;;){
-            if(cmp(*first2, *first1)){
-                iterator next = first2;
-                transfer(first1, first2, ++next);
-                first2 = next;
-                if(first2 == last2)
-                    return;
+    while(first1 != last1 && first2 != last2){
+        if(cmp(*first2, *first1)){
+            iterator next = first2;
+            transfer(first1, first2, ++next);
+            first2 = next;
+        }
+        else
+            ++first1;
+    }
+    if(first2 != last2)
+        transfer(last1, first2, last2);
+
+    // lst 的结点全部移了过来
+    node_count += lst.node_count;
+    lst.node_count = 0;
+}
+
+template<typename value_type, typename alloc>
+template<typename Comp>
+void list<value_type, alloc>::sort(const Comp& cmp){
+    if(node_count < 2) return;
+
+    node->prev->next = nullptr; // 断开成以 nullptr 结尾的单链表，排好后再补上 prev
+    link_type chain = node->next;
+    try{
+        if(node_count < _SORT_GATHER)
+            sort_chain(chain, cmp);
+        else
+            sort_gather(chain, node_count, cmp);
+    }
+    catch(...){
+        relink(chain); // 出错时 chain 仍然是所有结点连成的一条链
+        throw;
+    }
+    relink(chain);
+}
+
+// 把有序链 src 合并到有序链 dest 上，相等时 dest 的结点在前(dest 的元素原来就在前面)
+// cmp 抛出异常时两条链剩下的结点都接到 dest 上再抛出，一个结点也不丢
+template<typename value_type, typename alloc>
+template<typename Comp>
+void list<value_type, alloc>::merge_chain(link_type& dest, link_type src, const Comp& cmp){
+    link_type a = dest;
+    link_type* tail = &dest;
+    try{
+        while(a && src){
+            if(cmp(src->data, a->data)){
+                *tail = src;
+                src = src->next;
+            }else{
+                *tail = a;
+                a = a->next;
             }
-            else{
-                if(++first1 == last1)
-                    if(first2 != last2)
-                        transfer(last1, first2, last2);
-                    return;
+            tail = &(*tail)->next;
+        }
+    }
+    catch(...){
+        *tail = a;
+        while(*tail) tail = &(*tail)->next;
+        *tail = src;
+        throw;
+    }
+    *tail = a ? a : src;
+}
+
+// 自底向上归并：bucket[i] 是 2^i 个结点的有序链，下标大的链里的元素在前面
+// 每次取下一个结点，像二进制加一那样往上合并
+template<typename value_type, typename alloc>
+template<typename Comp>
+void list<value_type, alloc>::sort_chain(link_type& chain, const Comp& cmp){
+    link_type bucket[64] = { nullptr };
+    size_type fill = 0;
+    try{
+        while(chain){
+            link_type cur = chain;
+            chain = chain->next;
+            cur->next = nullptr;
+
+            size_type i = 0;
+            for(; i < fill && bucket[i]; ++i){
+                merge_chain(bucket[i], cur, cmp);
+                cur = bucket[i];
+                bucket[i] = nullptr;
             }
+            bucket[i] = cur;
+            if(i == fill) ++fill;
         }
+
+        link_type result = nullptr;
+        for(size_type i = 0; i < fill; ++i){
+            if(bucket[i] == nullptr) continue;
+            merge_chain(bucket[i], result, cmp);
+            result = bucket[i];
+            bucket[i] = nullptr;
+        }
+        chain = result;
+    }
+    catch(...){
+        chain = join_chains(bucket, fill, chain);
+        throw;
+    }
 }
 
-// 模板没必要写出来默认值 ----> Compare
-// 参数的缺省值也没必要写出来 -----> cmp = Compare()
-// 所有的默认值在类的声明处给出就行， 编译器会根据类名匹配自动在类里寻找对应的方法
+// 结点地址收集到数组里，先对每 32 个做插入排序，再在两个数组之间来回归并，最后按数组的顺序链接
 template<typename value_type, typename alloc>
-template<typename Compare>
-typename list<value_type, alloc>::iterator list<value_type, alloc>::
-merge_sort(iterator first, iterator last, size_type len, Compare& cmp){
-    if(len >= 2){
-        iterator med = first;
-        size_type half = len >> 1;
-        GHYSTL::advance(med, half);
-
-        first = merge(first, med, half, cmp); // 合并排序的思想
-        med = merge_sort(med, last, len - half, cmp); // 合并排序的思想
-
-        iterator new_first = first; // 记录最小值，下面的链接操作是把较大的值接到后面
-        if(cmp(*med, *first))
-            new_first = med;
-        
-        for(; ;){
-            if(cmp(*med, *first)){ // 后半段小，就把后半段插入到前面
-                splice(first, med++);
-                if(med == last)
-                    return new_first;
-            }else{
-                if(++first == med) 
-                    return new_first;
+template<typename Comp>
+void list<value_type, alloc>::sort_gather(link_type& chain, size_type n, const Comp& cmp){
+    typedef GHYSTL::allocator<link_type> ptr_alloc;
+    link_type* buf;
+    try{
+        buf = ptr_alloc::allocate(2 * n);
+    }
+    catch(...){
+        sort_chain(chain, cmp); // 申请不到数组就不用数组
+        return;
+    }
+
+    link_type* src = buf;
+    link_type* dest = buf + n;
+    link_type cur = chain;
+    for(size_type i = 0; i != n; ++i, cur = cur->next)
+        src[i] = cur;
+
+    try{
+        sort_runs(src, n, cmp);
+        for(size_type width = 32; width < n; width *= 2){
+            for(size_type lo = 0; lo < n; lo += 2 * width){
+                const size_type mid = lo + width < n ? lo + width : n;
+                const size_type hi = mid + width < n ? mid + width : n;
+                size_type i = lo, j = mid, k = lo;
+                while(i < mid && j < hi)
+                    dest[k++] = cmp(src[j]->data, src[i]->data) ? src[j++] : src[i++];
+                while(i < mid) dest[k++] = src[i++];
+                while(j < hi) dest[k++] = src[j++];
+            }
+            GHYSTL::swap(src, dest);
+        }
+    }
+    catch(...){
+        // 归并只读 src、写 dest，src 里始终是所有结点
+        chain = link_array(src, n);
+        ptr_alloc::deallocate(buf, 2 * n);
+        throw;
+    }
+
+    chain = link_array(src, n);
+    ptr_alloc::deallocate(buf, 2 * n);
+}
+
+// 每 32 个一段做插入排序
+template<typename value_type, typename alloc>
+template<typename Comp>
+void list<value_type, alloc>::sort_runs(link_type* buf, size_type n, const Comp& cmp){
+    for(size_type lo = 0; lo < n; lo += 32){
+        const size_type hi = lo + 32 < n ? lo + 32 : n;
+        for(size_type i = lo + 1; i < hi; ++i){
+            link_type val = buf[i];
+            size_type j = i;
+            try{
+                for(; j > lo && cmp(val->data, buf[j - 1]->data); --j)
+                    buf[j] = buf[j - 1];
+            }
+            catch(...){
+                buf[j] = val;
+                throw;
             }
+            buf[j] = val;
         }
+    }
+}
 
+// 把各个 bucket 里的链和剩下的 rest 首尾相接成一条链
+template<typename value_type, typename alloc>
+typename list<value_type, alloc>::link_type list<value_type, alloc>::join_chains(link_type* chains, size_type n, link_type rest){
+    link_type result = rest;
+    for(size_type i = 0; i != n; ++i){
+        if(chains[i] == nullptr) continue;
+        link_type tail = chains[i];
+        while(tail->next) tail = tail->next;
+        tail->next = result;
+        result = chains[i];
     }
+    return result;
+}
+
+template<typename value_type, typename alloc>
+typename list<value_type, alloc>::link_type list<value_type, alloc>::link_array(link_type* buf, size_type n){
+    for(size_type i = 0; i + 1 < n; ++i)
+        buf[i]->next = buf[i + 1];
+    buf[n - 1]->next = nullptr;
+    return buf[0];
+}
 
-    return first;
+// 按 next 的顺序补上 prev，重新接成以 node 为哨兵的环
+template<typename value_type, typename alloc>
+void list<value_type, alloc>::relink(link_type chain){
+    link_type prev = node;
+    for(; chain; chain = chain->next){
+        prev->next = chain;
+        chain->prev = prev;
+        prev = chain;
+    }
+    prev->next = node;
+    node->prev = prev;
 }
 
 template<typename value_type, typename alloc>
 void list<value_type, alloc>::clear(){
+    link_type chain = nullptr;
     for(link_type cur = node->next; cur != node; ){
         link_type tmp = cur->next;
-        destros_and_free_node(cur);
+        node_alloc::destroy(&(cur->data));
+        GHYSTL::batch_next(cur) = chain;
+        chain = cur;
         cur = tmp;
     }
+    GHYSTL::deallocate_nodes(this->get_alloc(), chain); // 所有结点一次还给分配器
     node->next = node;
     node->prev = node;
+    node_count = 0;
 }
 
 template<typename value_type, typename alloc>
@@ -744,7 +984,7 @@ template <typename value_type, typename alloc>
 inline bool operator==(const GHYSTL::list<value_type, alloc> &left,
                        const GHYSTL::list<value_type, alloc> &right)
 {
-  return (GHYSTL::equal(left.begin(), left.end(), right.begin(), right.end()));
+  return left.size() == right.size() && GHYSTL::equal(left.begin(), left.end(), right.begin(), right.end());
 }
 
 template <typename value_type, typename alloc>
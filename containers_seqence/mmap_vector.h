@@ -0,0 +1,431 @@
+/**
+ * @file mmap_vector.h
+ * @brief mmap_vector 实现：元素直接放在内存映射的文件里，打开文件就能用，不用逐个反序列化
+ *        文件内容就是 size() 个 T 按顺序排列，没有文件头，和直接 fwrite 出来的数组一样
+ *
+ * @version 1.0
+ *
+ */
+
+#pragma once
+#ifndef _MMAP_VECTOR_H_
+#define _MMAP_VECTOR_H_
+
+#include <cstring>
+#include <type_traits>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#endif
+
+#include "vector.h"
+
+namespace GHYSTL{
+
+    // 打开文件的方式
+    enum mmap_mode
+    {
+        mmap_read_only,         // 只读映射，不能修改也不能增删元素
+        mmap_read_write,        // 读写映射，修改直接写回文件，可以增删元素，文件不存在时创建
+        mmap_copy_on_write      // 私有映射，可以修改(比如原地排序)但不写回文件，不能增删元素
+    };
+
+
+    // --------------- mapped_file：文件和它的映射，区分平台 ---------------------------------
+
+    class mapped_file
+    {
+    public:
+        mapped_file() noexcept;
+
+        mapped_file(const mapped_file&) = delete;
+        mapped_file& operator=(const mapped_file&) = delete;
+
+        ~mapped_file() { close(); }
+
+        void open(const char* path, mmap_mode mode);
+        void close() noexcept;
+        bool is_open() const noexcept;
+
+        size_t file_size() const;
+        void set_file_size(size_t bytes);
+
+        // 把文件的前 bytes 个字节映射进来，bytes 为 0 时返回 nullptr
+        void* map(size_t bytes);
+        void unmap(void* addr, size_t bytes) noexcept;
+        void flush(void* addr, size_t bytes);
+
+        void swap(mapped_file& x) noexcept;
+
+    private:
+        mmap_mode mode;
+#ifdef _WIN32
+        HANDLE file;
+        HANDLE mapping;
+#else
+        int fd;
+#endif
+    };
+
+#ifdef _WIN32
+
+    inline mapped_file::mapped_file() noexcept : mode(mmap_read_only), file(INVALID_HANDLE_VALUE), mapping(NULL) {}
+
+    inline void mapped_file::open(const char* path, mmap_mode m){
+        close();
+        mode = m;
+        file = ::CreateFileA(path, m == mmap_read_write ? (GENERIC_READ | GENERIC_WRITE) : GENERIC_READ,
+                             FILE_SHARE_READ, NULL, m == mmap_read_write ? OPEN_ALWAYS : OPEN_EXISTING,
+                             FILE_ATTRIBUTE_NORMAL, NULL);
+        THROW_RUNTIME_ERROR_IF(file == INVALID_HANDLE_VALUE, "mmap_vector: cannot open file");
+    }
+
+    inline void mapped_file::close() noexcept {
+        if(file != INVALID_HANDLE_VALUE){
+            ::CloseHandle(file);
+            file = INVALID_HANDLE_VALUE;
+        }
+    }
+
+    inline bool mapped_file::is_open() const noexcept { return file != INVALID_HANDLE_VALUE; }
+
+    inline size_t mapped_file::file_size() const {
+        LARGE_INTEGER size;
+        THROW_RUNTIME_ERROR_IF(!::GetFileSizeEx(file, &size), "mmap_vector: cannot get file size");
+        return static_cast<size_t>(size.QuadPart);
+    }
+
+    inline void mapped_file::set_file_size(size_t bytes){
+        LARGE_INTEGER pos;
+        pos.QuadPart = static_cast<LONGLONG>(bytes);
+        THROW_RUNTIME_ERROR_IF(!::SetFilePointerEx(file, pos, NULL, FILE_BEGIN) || !::SetEndOfFile(file),
+                               "mmap_vector: cannot resize file");
+    }
+
+    inline void* mapped_file::map(size_t bytes){
+        if(bytes == 0) return nullptr;
+        const DWORD protect = mode == mmap_read_write ? PAGE_READWRITE : (mode == mmap_copy_on_write ? PAGE_WRITECOPY : PAGE_READONLY);
+        const DWORD access = mode == mmap_read_write ? FILE_MAP_WRITE : (mode == mmap_copy_on_write ? FILE_MAP_COPY : FILE_MAP_READ);
+        const unsigned long long size = bytes;
+        mapping = ::CreateFileMappingA(file, NULL, protect, DWORD(size >> 32), DWORD(size & 0xffffffffu), NULL);
+        THROW_RUNTIME_ERROR_IF(mapping == NULL, "mmap_vector: cannot map file");
+        void* addr = ::MapViewOfFile(mapping, access, 0, 0, bytes);
+        if(addr == NULL){
+            ::CloseHandle(mapping);
+            mapping = NULL;
+            THROW_RUNTIME_ERROR_IF(true, "mmap_vector: cannot map file");
+        }
+        return addr;
+    }
+
+    inline void mapped_file::unmap(void* addr, size_t) noexcept {
+        if(addr) ::UnmapViewOfFile(addr);
+        if(mapping){
+            ::CloseHandle(mapping);
+            mapping = NULL;
+        }
+    }
+
+    inline void mapped_file::flush(void* addr, size_t bytes){
+        if(addr == nullptr) return;
+        THROW_RUNTIME_ERROR_IF(!::FlushViewOfFile(addr, bytes) || !::FlushFileBuffers(file), "mmap_vector: cannot flush file");
+    }
+
+    inline void mapped_file::swap(mapped_file& x) noexcept {
+        GHYSTL::swap(mode, x.mode);
+        GHYSTL::swap(file, x.file);
+        GHYSTL::swap(mapping, x.mapping);
+    }
+
+#else
+
+    inline mapped_file::mapped_file() noexcept : mode(mmap_read_only), fd(-1) {}
+
+    inline void mapped_file::open(const char* path, mmap_mode m){
+        close();
+        mode = m;
+        fd = m == mmap_read_write ? ::open(path, O_RDWR | O_CREAT, 0644) : ::open(path, O_RDONLY);
+        THROW_RUNTIME_ERROR_IF(fd < 0, "mmap_vector: cannot open file");
+    }
+
+    inline void mapped_file::close() noexcept {
+        if(fd >= 0){
+            ::close(fd);
+            fd = -1;
+        }
+    }
+
+    inline bool mapped_file::is_open() const noexcept { return fd >= 0; }
+
+    inline size_t mapped_file::file_size() const {
+        struct stat st;
+        THROW_RUNTIME_ERROR_IF(::fstat(fd, &st) != 0, "mmap_vector: cannot get file size");
+        return static_cast<size_t>(st.st_size);
+    }
+
+    inline void mapped_file::set_file_size(size_t bytes){
+        THROW_RUNTIME_ERROR_IF(::ftruncate(fd, static_cast<off_t>(bytes)) != 0, "mmap_vector: cannot resize file");
+    }
+
+    inline void* mapped_file::map(size_t bytes){
+        if(bytes == 0) return nullptr;
+        const int prot = mode == mmap_read_only ? PROT_READ : (PROT_READ | PROT_WRITE);
+        const int flags = mode == mmap_read_write ? MAP_SHARED : MAP_PRIVATE;
+        void* addr = ::mmap(nullptr, bytes, prot, flags, fd, 0);
+        THROW_RUNTIME_ERROR_IF(addr == MAP_FAILED, "mmap_vector: cannot map file");
+        return addr;
+    }
+
+    inline void mapped_file::unmap(void* addr, size_t bytes) noexcept {
+        if(addr) ::munmap(addr, bytes);
+    }
+
+    inline void mapped_file::flush(void* addr, size_t bytes){
+        if(addr == nullptr) return;
+        THROW_RUNTIME_ERROR_IF(::msync(addr, bytes, MS_SYNC) != 0, "mmap_vector: cannot flush file");
+    }
+
+    inline void mapped_file::swap(mapped_file& x) noexcept {
+        GHYSTL::swap(mode, x.mode);
+        GHYSTL::swap(fd, x.fd);
+    }
+
+#endif
+
+
+    // --------------- mmap_vector ---------------------------------
+
+    // 只能存放可以按字节复制的类型，迭代器和 vector 一样是 vector_iterator，sort、lower_bound、accumulate 照常使用
+    // 读写映射时文件长度就是容量，扩容时先 ftruncate 加长文件再重新映射；close() 时把文件截到 size() 个元素
+    template<class T>
+    class mmap_vector
+    {
+        static_assert(std::is_trivially_copyable<T>::value, "mmap_vector requires a trivially copyable type");
+
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef const T*    const_pointer;
+        typedef T&          reference;
+        typedef const T&    const_reference;
+        typedef size_t      size_type;
+        typedef ptrdiff_t   difference_type;
+
+        typedef vector_iterator<value_type>                 iterator;
+        typedef vector_const_iterator<value_type>           const_iterator;
+        typedef GHYSTL::reverse_iterator<iterator>          reverse_iterator;
+        typedef GHYSTL::reverse_iterator<const_iterator>    const_reverse_iterator;
+
+    private:
+        typedef mmap_vector<T>  self;
+
+    public:
+        /*------------------------ ---------------- 构造函数  -------------------------------------------*/
+
+        mmap_vector() noexcept : first(nullptr), len(0), cap(0), mode(mmap_read_only) {}
+
+        explicit mmap_vector(const char* path, mmap_mode mode = mmap_read_only) : mmap_vector() {
+            open(path, mode);
+        }
+
+        mmap_vector(const self&) = delete;
+        self& operator=(const self&) = delete;
+
+        mmap_vector(self&& x) noexcept : mmap_vector() { swap(x); }
+
+        self& operator=(self&& x) noexcept {
+            if(this != &x){
+                self tmp(std::move(x));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~mmap_vector(){
+            try{
+                close();
+            }
+            catch(...){
+            }
+        }
+
+        // 读写方式打开时文件不存在就创建；文件长度不是 sizeof(T) 的整数倍时多出来的字节不算元素
+        void open(const char* path, mmap_mode m = mmap_read_only){
+            close();
+            file.open(path, m);
+            mode = m;
+            try{
+                len = cap = file.file_size() / sizeof(value_type);
+                first = static_cast<pointer>(file.map(cap * sizeof(value_type)));
+            }
+            catch(...){
+                file.close();
+                len = cap = 0;
+                throw;
+            }
+        }
+
+        // 读写映射时把文件截到 size() 个元素，解除映射并关闭文件
+        void close(){
+            if(!file.is_open()) return;
+            file.unmap(first, cap * sizeof(value_type));
+            first = nullptr;
+            if(mode == mmap_read_write && cap != len)
+                file.set_file_size(len * sizeof(value_type));
+            file.close();
+            len = cap = 0;
+        }
+
+        // 把修改过的页写回文件
+        void flush(){
+            if(mode == mmap_read_write)
+                file.flush(first, cap * sizeof(value_type));
+        }
+
+        bool is_open() const noexcept { return file.is_open(); }
+
+        bool writable() const noexcept { return mode != mmap_read_only; }
+
+        /*------------------------ ---------------- 常规函数  -------------------------------------------*/
+
+        size_type size() const noexcept { return len; }
+
+        size_type capacity() const noexcept { return cap; }
+
+        bool empty() const noexcept { return len == 0; }
+
+        pointer data() noexcept { return first; }
+        const_pointer data() const noexcept { return first; }
+
+        reference operator[](const size_type n){
+            GHYSTL_DEBUG(n < size());
+            return first[n];
+        }
+
+        const_reference operator[](const size_type n) const {
+            GHYSTL_DEBUG(n < size());
+            return first[n];
+        }
+
+        reference at(const size_type n){
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "mmap_vector<T>::at() subscript out of range");
+            return first[n];
+        }
+
+        const_reference at(const size_type n) const {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "mmap_vector<T>::at() subscript out of range");
+            return first[n];
+        }
+
+        reference front() { return first[0]; }
+        const_reference front() const { return first[0]; }
+
+        reference back() { return first[len - 1]; }
+        const_reference back() const { return first[len - 1]; }
+
+        void reserve(const size_type n){
+            if(n > cap)
+                remap(n);
+        }
+
+        void shrink_to_fit(){
+            if(cap != len)
+                remap(len);
+        }
+
+        // 新增的元素清零
+        void resize(const size_type n){
+            if(n > cap)
+                remap(n);
+            if(n > len)
+                std::memset(static_cast<void*>(first + len), 0, sizeof(value_type) * (n - len));
+            else
+                check_resizable();
+            len = n;
+        }
+
+        void clear(){
+            check_resizable();
+            len = 0;
+        }
+
+        void push_back(const value_type& val){
+            if(len == cap)
+                remap(cap ? 2 * cap : 1);
+            first[len++] = val;
+        }
+
+        void pop_back(){
+            check_resizable();
+            GHYSTL_DEBUG(!empty());
+            --len;
+        }
+
+        void swap(self& x) noexcept {
+            file.swap(x.file);
+            GHYSTL::swap(first, x.first);
+            GHYSTL::swap(len, x.len);
+            GHYSTL::swap(cap, x.cap);
+            GHYSTL::swap(mode, x.mode);
+        }
+
+        /*------------------------ ---------------- 迭代器操作函数 -------------------------------------------*/
+
+        iterator begin() { return iterator(first); }
+        iterator end() { return iterator(first + len); }
+
+        const_iterator begin() const { return const_iterator(first); }
+        const_iterator end() const { return const_iterator(first + len); }
+
+        const_iterator cbegin() const { return begin(); }
+        const_iterator cend() const { return end(); }
+
+        reverse_iterator rbegin() { return reverse_iterator(end()); }
+        reverse_iterator rend() { return reverse_iterator(begin()); }
+
+        const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+        const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+    private:
+        void check_resizable() const {
+            THROW_RUNTIME_ERROR_IF(mode != mmap_read_write, "mmap_vector: the file is not opened for read-write");
+        }
+
+        // 把文件调整为 n 个元素再重新映射；失败时按文件现在的长度重新映射，原来的元素还在文件开头
+        void remap(const size_type n){
+            check_resizable();
+            file.unmap(first, cap * sizeof(value_type));
+            first = nullptr;
+            try{
+                file.set_file_size(n * sizeof(value_type));
+                first = static_cast<pointer>(file.map(n * sizeof(value_type)));
+            }
+            catch(...){
+                cap = file.file_size() / sizeof(value_type);
+                if(len > cap) len = cap;
+                first = static_cast<pointer>(file.map(cap * sizeof(value_type)));
+                throw;
+            }
+            cap = n;
+            if(len > cap) len = cap;
+        }
+
+    private:
+        mapped_file file;
+        pointer first;      // 映射的起始地址
+        size_type len;      // 元素个数
+        size_type cap;      // 文件里能放下的元素个数
+        mmap_mode mode;
+    };
+
+    template<class T>
+    inline void swap(mmap_vector<T>& left, mmap_vector<T>& right) noexcept {
+        left.swap(right);
+    }
+}
+#endif
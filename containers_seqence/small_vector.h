@@ -0,0 +1,261 @@
+/**
+ * @file small_vector.h
+ * @brief small_vector 实现：前 N 个元素放在对象内部，超过 N 个才向分配器申请空间
+ *        建立在 vector 之上，迭代器、插入删除、扩容策略都和 vector 共用
+ *
+ * @version 1.0
+ *
+ */
+
+#pragma once
+#ifndef _SMALL_VECTOR_H_
+#define _SMALL_VECTOR_H_
+
+#include "vector.h"
+
+namespace GHYSTL{
+
+    // --------------- small_vector 的内置空间 ---------------------------------
+
+    template<typename T, size_t N>
+    struct small_vector_buffer
+    {
+        alignas(T) unsigned char data[N * sizeof(T)];
+        bool in_use; // 内置空间是否正被 vector 使用
+
+        small_vector_buffer() : in_use(false) {}
+
+        T* storage() noexcept { return reinterpret_cast<T*>(data); }
+        const T* storage() const noexcept { return reinterpret_cast<const T*>(data); }
+    };
+
+
+    // --------------- small_vector 的分配器 ---------------------------------
+
+    // 持有内置空间的指针，是一个有状态的分配器
+    // 不超过 N 个元素并且内置空间空闲时分配内置空间，否则交给二级配置器
+    template<typename value_type_, size_t N>
+    class small_vector_allocator
+                : public allocator_base<value_type_, default_alloc>
+    {
+    public:
+        typedef allocator_base<value_type_, default_alloc>               base_type;
+        typedef typename base_type::value_type                           value_type;
+        typedef typename base_type::pointer                              pointer;
+        typedef typename base_type::const_pointer                        const_pointer;
+        typedef typename base_type::reference                            reference;
+        typedef typename base_type::const_reference                      const_reference;
+        typedef typename base_type::size_type                            size_type;
+        typedef typename base_type::difference_type                      difference_type;
+        typedef typename base_type::alloc                                alloc;
+        typedef small_vector_buffer<value_type, N>                       buffer_type;
+
+        // 换成别的类型后不再持有内置空间
+        template<typename value_type>
+        struct rebind
+        {
+            typedef small_vector_allocator<value_type, N> other;
+        };
+
+        // 没有内置空间时和普通的 allocator 一样
+        small_vector_allocator() noexcept : buffer(nullptr) {}
+
+        explicit small_vector_allocator(buffer_type* buffer) noexcept : buffer(buffer) {}
+
+        pointer allocate(const size_type n) const {
+            if(buffer && n <= N && !buffer->in_use){
+                buffer->in_use = true;
+                return buffer->storage();
+            }
+            return base_type::allocate(n);
+        }
+
+        void deallocate(pointer ptr, size_type n) const {
+            if(is_inline(ptr))
+                buffer->in_use = false;
+            else
+                base_type::deallocate(ptr, n);
+        }
+
+        // 只用于可以按字节搬动的类型：内置空间和堆之间要自己复制，两块都在堆上时交给配置器
+        pointer reallocate(pointer ptr, size_type old_n, size_type new_n) const {
+            static_assert(is_trivially_relocatable<value_type>::value,
+                          "reallocate requires a trivially relocatable value_type");
+            if(ptr == nullptr || old_n == 0) return allocate(new_n);
+            if(new_n == 0){
+                deallocate(ptr, old_n);
+                return nullptr;
+            }
+            if(is_inline(ptr)){
+                if(new_n <= N) return ptr;
+                pointer result = base_type::allocate(new_n);
+                std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr), sizeof(value_type) * old_n);
+                buffer->in_use = false;
+                return result;
+            }
+            if(buffer && new_n <= N && !buffer->in_use){
+                pointer result = allocate(new_n);
+                std::memcpy(static_cast<void*>(result), static_cast<const void*>(ptr), sizeof(value_type) * (old_n < new_n ? old_n : new_n));
+                base_type::deallocate(ptr, old_n);
+                return result;
+            }
+            return base_type::reallocate(ptr, old_n, new_n);
+        }
+
+        bool is_inline(const_pointer ptr) const noexcept { return buffer && ptr == buffer->storage(); }
+
+        buffer_type* resource() const noexcept { return buffer; }
+
+    private:
+        buffer_type* buffer;
+    };
+
+    template<typename T, size_t N>
+    inline bool operator==(const small_vector_allocator<T, N>& left, const small_vector_allocator<T, N>& right) noexcept {
+        return left.resource() == right.resource();
+    }
+
+    template<typename T, size_t N>
+    inline bool operator!=(const small_vector_allocator<T, N>& left, const small_vector_allocator<T, N>& right) noexcept {
+        return !(left == right);
+    }
+
+
+    // --------------- small_vector ---------------------------------
+
+    // 内置空间作为第一个基类，先于 vector 构造、晚于 vector 析构
+    // 一开始容量就是 N，超过 N 之后按 Growth 扩容到堆上；堆上的元素不超过 N 个时 shrink_to_fit 会搬回内置空间
+    template<class T, size_t N, class Growth = GHYSTL::growth_double>
+    class small_vector
+        : private small_vector_buffer<T, N>,
+          public vector<T, small_vector_allocator<T, N>, Growth>
+    {
+        static_assert(N > 0, "small_vector needs at least one inline element");
+
+    public:
+        typedef vector<T, small_vector_allocator<T, N>, Growth>  base_type;
+        typedef typename base_type::value_type                  value_type;
+        typedef typename base_type::pointer                     pointer;
+        typedef typename base_type::const_pointer               const_pointer;
+        typedef typename base_type::reference                   reference;
+        typedef typename base_type::const_reference             const_reference;
+        typedef typename base_type::size_type                   size_type;
+        typedef typename base_type::difference_type             difference_type;
+        typedef typename base_type::iterator                    iterator;
+        typedef typename base_type::const_iterator              const_iterator;
+        typedef typename base_type::reverse_iterator            reverse_iterator;
+        typedef typename base_type::const_reverse_iterator      const_reverse_iterator;
+        typedef typename base_type::allocator_type              allocator_type;
+
+        enum { inline_capacity = N };
+
+    private:
+        typedef small_vector<T, N, Growth>      self;
+        typedef small_vector_buffer<T, N>       buffer_type;
+
+    public:
+        /*------------------------ ---------------- 构造函数  -------------------------------------------*/
+
+        small_vector() : base_type(allocator_type(buffer())) { init_inline(); }
+
+        explicit small_vector(const size_type n) : small_vector() { this->resize(n); }
+
+        small_vector(const size_type n, const value_type& val) : small_vector() { this->assign(n, val); }
+
+        small_vector(const std::initializer_list<T>& lst) : small_vector() { this->assign(lst.begin(), lst.end()); }
+
+        template<typename Iter,
+                typename = typename GHYSTL::enable_if<is_iterator<Iter>::value, void>::type>
+        small_vector(Iter bg, Iter ed) : small_vector() { this->assign(bg, ed); }
+
+        small_vector(const self& x) : small_vector() { this->assign(x.begin(), x.end()); }
+
+        small_vector(self&& x) noexcept(std::is_nothrow_move_constructible<T>::value) : small_vector() {
+            take(x);
+        }
+
+        self& operator=(const self& x){
+            if(this != &x)
+                this->assign(x.begin(), x.end());
+            return *this;
+        }
+
+        self& operator=(self&& x) noexcept(std::is_nothrow_move_constructible<T>::value) {
+            if(this != &x){
+                release();
+                take(x);
+            }
+            return *this;
+        }
+
+        self& operator=(const std::initializer_list<value_type>& lst){
+            this->assign(lst.begin(), lst.end());
+            return *this;
+        }
+
+        /*------------------------ ---------------- 常规函数  -------------------------------------------*/
+
+        // 元素是否还在内置空间里
+        bool is_inline() const noexcept { return this->first == buffer()->storage(); }
+
+        // 已经在内置空间里就不用动，堆上的元素放得进内置空间时搬回来
+        void shrink_to_fit(){
+            if(!is_inline()){
+                base_type::shrink_to_fit();
+                if(is_inline())
+                    this->end_storage = this->first + N;
+            }
+        }
+
+        void swap(self& x){
+            if(this != &x){
+                self tmp(std::move(x));
+                x = std::move(*this);
+                *this = std::move(tmp);
+            }
+        }
+
+    private:
+        buffer_type* buffer() noexcept { return static_cast<buffer_type*>(this); }
+        const buffer_type* buffer() const noexcept { return static_cast<const buffer_type*>(this); }
+
+        // 让 vector 直接使用内置空间，容量为 N
+        void init_inline() noexcept {
+            buffer()->in_use = true;
+            this->first = this->last = buffer()->storage();
+            this->end_storage = this->first + N;
+        }
+
+        // 析构所有元素并释放堆上的空间，回到空的内置空间
+        void release(){
+            this->clear();
+            if(!is_inline()){
+                this->get_allocator().deallocate(this->first, this->capacity());
+                init_inline();
+            }
+        }
+
+        // 接管 x 的元素：x 在堆上时直接拿走它的空间，在内置空间里时逐个移动过来
+        // 调用前自己必须是空的内置空间，调用后 x 也是空的内置空间
+        void take(self& x){
+            if(x.is_inline()){
+                for(pointer p = x.first; p != x.last; ++p)
+                    this->emplace_back(std::move(*p));
+                x.clear();
+            }
+            else{
+                buffer()->in_use = false;
+                this->first = x.first;
+                this->last = x.last;
+                this->end_storage = x.end_storage;
+                x.init_inline();
+            }
+        }
+    };
+
+    template<class T, size_t N, class Growth>
+    inline void swap(small_vector<T, N, Growth>& left, small_vector<T, N, Growth>& right){
+        left.swap(right);
+    }
+}
+#endif
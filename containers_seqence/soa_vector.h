@@ -0,0 +1,471 @@
+/**
+ * @file soa_vector.h
+ * @brief soa_vector 实现：多字段记录按列存储(structure of arrays)，每个字段一段连续的数组
+ *        只扫描一两个字段时不用把整条记录读进缓存
+ *
+ * @version 1.0
+ *
+ */
+
+#pragma once
+#ifndef _SOA_VECTOR_H_
+#define _SOA_VECTOR_H_
+
+#include <tuple>
+#include <utility>
+
+#include "vector.h"
+
+namespace GHYSTL{
+
+    // --------------- soa_span：soa_vector 的一列 ---------------------------------
+
+    // 一段连续的同类型元素，迭代器就是指针，可以直接交给 GHYSTL 的算法
+    template<typename T>
+    class soa_span
+    {
+    public:
+        typedef T           value_type;
+        typedef T*          pointer;
+        typedef T&          reference;
+        typedef T*          iterator;
+        typedef size_t      size_type;
+
+        soa_span(pointer first, size_type n) noexcept : first(first), n(n) {}
+
+        iterator begin() const noexcept { return first; }
+        iterator end() const noexcept { return first + n; }
+
+        pointer data() const noexcept { return first; }
+        size_type size() const noexcept { return n; }
+        bool empty() const noexcept { return n == 0; }
+
+        reference operator[](const size_type i) const {
+            GHYSTL_DEBUG(i < n);
+            return first[i];
+        }
+
+    private:
+        pointer first;
+        size_type n;
+    };
+
+
+    // --------------- soa_vector ---------------------------------
+
+    // 每个字段各自一段数组，所有数组共用一个 size 和 capacity
+    // column<I>() 取第 I 个字段的一整列，operator[] 取一行的代理引用
+    // 排序先用 GHYSTL::sort 排行号，再按行号把每一列重新排列一次
+    template<typename... Fields>
+    class soa_vector
+    {
+        static_assert(sizeof...(Fields) > 0, "soa_vector needs at least one field");
+
+    public:
+        typedef std::tuple<Fields...>   value_type;
+        typedef size_t                  size_type;
+        typedef ptrdiff_t               difference_type;
+
+        enum { field_count = sizeof...(Fields) };
+
+        // 第 I 个字段的类型
+        template<size_t I>
+        struct field
+        {
+            typedef typename std::tuple_element<I, value_type>::type type;
+        };
+
+    private:
+        typedef soa_vector<Fields...>           self;
+        typedef std::tuple<Fields*...>          columns_type;
+        typedef std::index_sequence_for<Fields...> field_indices;
+
+        template<size_t I>
+        struct column_alloc
+        {
+            typedef GHYSTL::allocator<typename field<I>::type> type;
+        };
+
+    public:
+        // 一行的代理引用，保存容器和行号；get<I>() 返回这一行第 I 个字段的引用
+        template<typename Owner>
+        class basic_row
+        {
+        public:
+            basic_row(Owner* owner, size_type index) noexcept : owner(owner), index(index) {}
+
+            template<size_t I>
+            auto get() const -> decltype(std::declval<Owner&>().template data<I>()[0]) {
+                return owner->template data<I>()[index];
+            }
+
+            size_type row() const noexcept { return index; }
+
+            // 复制出整行
+            operator value_type() const {
+                return to_value(field_indices());
+            }
+
+        protected:
+            template<size_t... I>
+            value_type to_value(std::index_sequence<I...>) const {
+                return value_type(get<I>()...);
+            }
+
+            Owner* owner;
+            size_type index;
+        };
+
+        typedef basic_row<const self> const_reference;
+
+        class reference : public basic_row<self>
+        {
+        public:
+            reference(self* owner, size_type index) noexcept : basic_row<self>(owner, index) {}
+
+            // 给整行赋值，写的是容器里的元素而不是代理本身
+            const reference& operator=(const value_type& val) const {
+                assign(val, field_indices());
+                return *this;
+            }
+
+            const reference& operator=(const reference& x) const {
+                return *this = static_cast<value_type>(x);
+            }
+
+            operator const_reference() const noexcept { return const_reference(this->owner, this->index); }
+
+        private:
+            template<size_t... I>
+            void assign(const value_type& val, std::index_sequence<I...>) const {
+                int expand[] = { 0, ((this->template get<I>() = std::get<I>(val)), 0)... };
+                (void)expand;
+            }
+        };
+
+    public:
+        /*------------------------ ---------------- 构造函数  -------------------------------------------*/
+
+        soa_vector() noexcept : len(0), cap(0) { null_columns(columns, field_indices()); }
+
+        explicit soa_vector(const size_type n) : soa_vector() { resize(n); }
+
+        soa_vector(const self& x) : soa_vector() {
+            reserve(x.size());
+            for(size_type i = 0; i != x.size(); ++i)
+                push_back(static_cast<value_type>(x[i]));
+        }
+
+        soa_vector(self&& x) noexcept : columns(x.columns), len(x.len), cap(x.cap) {
+            null_columns(x.columns, field_indices());
+            x.len = x.cap = 0;
+        }
+
+        self& operator=(const self& x){
+            if(this != &x){
+                self tmp(x);
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        self& operator=(self&& x) noexcept {
+            if(this != &x){
+                self tmp(std::move(x));
+                swap(tmp);
+            }
+            return *this;
+        }
+
+        ~soa_vector(){
+            clear();
+            deallocate_columns(columns, cap, field_indices());
+        }
+
+        /*------------------------ ---------------- 常规函数  -------------------------------------------*/
+
+        size_type size() const noexcept { return len; }
+
+        size_type capacity() const noexcept { return cap; }
+
+        bool empty() const noexcept { return len == 0; }
+
+        // 第 I 个字段的数组
+        template<size_t I>
+        typename field<I>::type* data() noexcept { return std::get<I>(columns); }
+
+        template<size_t I>
+        const typename field<I>::type* data() const noexcept { return std::get<I>(columns); }
+
+        // 第 I 个字段的一整列
+        template<size_t I>
+        soa_span<typename field<I>::type> column() noexcept {
+            return soa_span<typename field<I>::type>(data<I>(), len);
+        }
+
+        template<size_t I>
+        soa_span<const typename field<I>::type> column() const noexcept {
+            return soa_span<const typename field<I>::type>(data<I>(), len);
+        }
+
+        reference operator[](const size_type n){
+            GHYSTL_DEBUG(n < size());
+            return reference(this, n);
+        }
+
+        const_reference operator[](const size_type n) const {
+            GHYSTL_DEBUG(n < size());
+            return const_reference(this, n);
+        }
+
+        reference at(const size_type n){
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "soa_vector<T>::at() subscript out of range");
+            return reference(this, n);
+        }
+
+        const_reference at(const size_type n) const {
+            THROW_OUT_OF_RANGE_IF(!(n < size()), "soa_vector<T>::at() subscript out of range");
+            return const_reference(this, n);
+        }
+
+        reference front() { return (*this)[0]; }
+        const_reference front() const { return (*this)[0]; }
+
+        reference back() { return (*this)[len - 1]; }
+        const_reference back() const { return (*this)[len - 1]; }
+
+        void reserve(const size_type n){
+            if(n > cap)
+                reallocate_columns(n);
+        }
+
+        void shrink_to_fit(){
+            if(cap != len)
+                reallocate_columns(len);
+        }
+
+        void push_back(const value_type& val){
+            emplace_row(val);
+        }
+
+        void push_back(value_type&& val){
+            emplace_row(std::move(val));
+        }
+
+        // 按字段顺序给出一行的每个字段
+        template<typename... types>
+        void emplace_back(types&&... args){
+            static_assert(sizeof...(types) == sizeof...(Fields), "emplace_back takes one argument per field");
+            emplace_row(std::forward_as_tuple(std::forward<types>(args)...));
+        }
+
+        void pop_back(){
+            GHYSTL_DEBUG(!empty());
+            --len;
+            destroy_rows(len, len + 1, field_indices());
+        }
+
+        void clear(){
+            destroy_rows(0, len, field_indices());
+            len = 0;
+        }
+
+        // 多出来的行默认构造(值初始化)
+        void resize(const size_type n){
+            if(n < len){
+                destroy_rows(n, len, field_indices());
+                len = n;
+            }else{
+                reserve(n);
+                for(; len != n; ++len)
+                    construct_row<0>(columns, len, std::tuple<>(), GHYSTL::bool_type<(0 < field_count)>());
+            }
+        }
+
+        void swap(self& x) noexcept {
+            GHYSTL::swap(columns, x.columns);
+            GHYSTL::swap(len, x.len);
+            GHYSTL::swap(cap, x.cap);
+        }
+
+        // 重新排列：排列之后的第 i 行是原来的第 order[i] 行，order 是 [0, size()) 的一个排列
+        void permute(const size_type* order){
+            permute_columns(order, field_indices());
+        }
+
+        // cmp(const_reference, const_reference) 比较两行
+        template<typename Comp>
+        void sort(const Comp& cmp){
+            const self* owner = this;
+            sort_rows([owner, &cmp](size_type a, size_type b){ return cmp((*owner)[a], (*owner)[b]); });
+        }
+
+        // 按第 I 个字段排序
+        template<size_t I, typename Comp>
+        void sort_by(const Comp& cmp){
+            const typename field<I>::type* col = data<I>();
+            sort_rows([col, &cmp](size_type a, size_type b){ return cmp(col[a], col[b]); });
+        }
+
+        template<size_t I>
+        void sort_by(){
+            sort_by<I>(GHYSTL::less<typename field<I>::type>());
+        }
+
+    private:
+        /*------------------------ ---------------- 按列展开的辅助函数  -------------------------------------------*/
+
+        template<size_t... I>
+        static void null_columns(columns_type& cols, std::index_sequence<I...>) noexcept {
+            int expand[] = { 0, ((std::get<I>(cols) = nullptr), 0)... };
+            (void)expand;
+        }
+
+        template<size_t... I>
+        static void deallocate_columns(columns_type& cols, size_type n, std::index_sequence<I...>){
+            int expand[] = { 0, (column_alloc<I>::type::deallocate(std::get<I>(cols), n), 0)... };
+            (void)expand;
+        }
+
+        // 每一列都分配 n 个元素的空间，中途失败时释放已经分配的列
+        template<size_t... I>
+        static void allocate_columns(columns_type& cols, size_type n, std::index_sequence<I...> seq){
+            null_columns(cols, seq);
+            try{
+                int expand[] = { 0, ((std::get<I>(cols) = column_alloc<I>::type::allocate(n)), 0)... };
+                (void)expand;
+            }
+            catch(...){
+                deallocate_columns(cols, n, seq);
+                throw;
+            }
+        }
+
+        template<size_t... I>
+        void destroy_rows(size_type first, size_type last, std::index_sequence<I...>){
+            int expand[] = { 0, (column_alloc<I>::type::destroy(std::get<I>(columns) + first, std::get<I>(columns) + last), 0)... };
+            (void)expand;
+        }
+
+        // 把每一列搬到 n 个元素的新空间
+        void reallocate_columns(const size_type n){
+            columns_type fresh;
+            allocate_columns(fresh, n, field_indices());
+            adopt_columns(fresh, n);
+        }
+
+        // 把已有的行搬到 fresh，释放原来的空间
+        void adopt_columns(columns_type& fresh, const size_type n){
+            move_columns(fresh, field_indices());
+            deallocate_columns(columns, cap, field_indices());
+            columns = fresh;
+            cap = n;
+        }
+
+        template<size_t... I>
+        void move_columns(columns_type& dest, std::index_sequence<I...>){
+            int expand[] = { 0, (move_column<I>(std::get<I>(dest)), 0)... };
+            (void)expand;
+        }
+
+        template<size_t I>
+        void move_column(typename field<I>::type* dest){
+            typedef typename column_alloc<I>::type alloc;
+            typename field<I>::type* src = std::get<I>(columns);
+            for(size_type i = 0; i != len; ++i)
+                alloc::construct(dest + i, std::move(src[i]));
+            alloc::destroy(src, src + len);
+        }
+
+        // 在 cols 的第 pos 行逐列构造，tuple 里没有对应的值时值初始化；某一列失败时析构这一行已经构造好的列
+        template<size_t I, typename Tuple>
+        static void construct_row(columns_type& cols, size_type pos, Tuple&& t, GHYSTL::true_type){
+            typedef typename column_alloc<I>::type alloc;
+            construct_field<I>(cols, pos, std::forward<Tuple>(t),
+                               GHYSTL::bool_type<(I < std::tuple_size<typename std::decay<Tuple>::type>::value)>());
+            try{
+                construct_row<I + 1>(cols, pos, std::forward<Tuple>(t), GHYSTL::bool_type<(I + 1 < field_count)>());
+            }
+            catch(...){
+                alloc::destroy(std::get<I>(cols) + pos);
+                throw;
+            }
+        }
+
+        template<size_t I, typename Tuple>
+        static void construct_row(columns_type&, size_type, Tuple&&, GHYSTL::false_type) {}
+
+        template<size_t I, typename Tuple>
+        static void construct_field(columns_type& cols, size_type pos, Tuple&& t, GHYSTL::true_type){
+            column_alloc<I>::type::construct(std::get<I>(cols) + pos, std::get<I>(std::forward<Tuple>(t)));
+        }
+
+        template<size_t I, typename Tuple>
+        static void construct_field(columns_type& cols, size_type pos, Tuple&&, GHYSTL::false_type){
+            column_alloc<I>::type::construct(std::get<I>(cols) + pos);
+        }
+
+        // 扩容时先在新空间构造新的一行，再搬旧的行，参数引用本容器里的元素也不会读到已释放的空间
+        template<typename Tuple>
+        void emplace_row(Tuple&& t){
+            if(len == cap){
+                const size_type n = cap ? 2 * cap : 1; // 和 vector 默认的一样翻倍
+                columns_type fresh;
+                allocate_columns(fresh, n, field_indices());
+                try{
+                    construct_row<0>(fresh, len, std::forward<Tuple>(t), GHYSTL::true_type());
+                }
+                catch(...){
+                    deallocate_columns(fresh, n, field_indices());
+                    throw;
+                }
+                adopt_columns(fresh, n);
+            }
+            else
+                construct_row<0>(columns, len, std::forward<Tuple>(t), GHYSTL::true_type());
+            ++len;
+        }
+
+        template<size_t... I>
+        void permute_columns(const size_type* order, std::index_sequence<I...>){
+            int expand[] = { 0, (permute_column<I>(order), 0)... };
+            (void)expand;
+        }
+
+        // 按 order 把一列搬到新空间，再换掉原来的空间
+        template<size_t I>
+        void permute_column(const size_type* order){
+            typedef typename column_alloc<I>::type alloc;
+            typename field<I>::type* src = std::get<I>(columns);
+            typename field<I>::type* dest = alloc::allocate(cap);
+            for(size_type i = 0; i != len; ++i)
+                alloc::construct(dest + i, std::move(src[order[i]]));
+            alloc::destroy(src, src + len);
+            alloc::deallocate(src, cap);
+            std::get<I>(columns) = dest;
+        }
+
+        // 排的是行号，比较的时候按行号去各列取值，排好之后每一列只搬一次
+        template<typename Comp>
+        void sort_rows(const Comp& cmp){
+            if(len < 2) return;
+            GHYSTL::vector<size_type> order;
+            order.resize_default_init(len);
+            for(size_type i = 0; i != len; ++i)
+                order[i] = i;
+            GHYSTL::sort(order.begin(), order.end(), cmp);
+            permute(order.data());
+        }
+
+    private:
+        columns_type columns;   // 每个字段一段数组
+        size_type len;          // 行数
+        size_type cap;          // 每一段数组能放下的行数
+    };
+
+    template<typename... Fields>
+    inline void swap(soa_vector<Fields...>& left, soa_vector<Fields...>& right) noexcept {
+        left.swap(right);
+    }
+}
+#endif
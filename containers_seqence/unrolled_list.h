@@ -0,0 +1,731 @@
+/**
+ * @file unrolled_list.h
+ * @brief 展开链表：每个结点存一小段连续的元素，遍历时大部分时间在结点内顺序访问
+ *
+ * @version 1.0
+ *
+ */
+
+#pragma once
+#ifndef _UNROLLED_LIST_H_
+#define _UNROLLED_LIST_H_
+
+#include "../algorithm/algorithm.h"
+
+namespace GHYSTL{
+
+/************************************************ 结点 ************************************************************/
+
+// 每个结点默认放 512 字节左右的元素，大元素至少放 8 个
+template<typename T>
+struct unrolled_list_node_size
+{
+    static constexpr size_t value = sizeof(T) < 64 ? 512 / sizeof(T) : 8;
+};
+
+template<typename value_type_>
+struct unrolled_list_base_node{
+    typedef unrolled_list_base_node<value_type_>* base_ptr;
+
+    base_ptr prev;
+    base_ptr next;
+};
+
+// 元素放在 [data(), data() + count) 里，除了哨兵以外每个结点至少有一个元素
+template<typename value_type_, size_t N>
+struct unrolled_list_node : unrolled_list_base_node<value_type_>
+{
+    typedef value_type_                     value_type;
+
+    size_t count;
+    alignas(value_type) unsigned char buf[N * sizeof(value_type)];
+
+    value_type* data() noexcept { return reinterpret_cast<value_type*>(buf); }
+    const value_type* data() const noexcept { return reinterpret_cast<const value_type*>(buf); }
+};
+
+
+/************************************************ 迭代器 ************************************************************/
+
+// 迭代器是 (结点, 结点内下标)，end() 是 (哨兵, 0)
+template<typename value_type_, size_t N>
+class unrolled_list_const_iterator
+{
+public:
+    template<typename T, size_t M, typename Alloc>
+    friend class unrolled_list;
+
+    typedef GHYSTL::bidirectional_iterator_tag                  iterator_category;
+    typedef value_type_                                         value_type;
+    typedef const value_type*                                   pointer;
+    typedef const value_type&                                   reference;
+    typedef ptrdiff_t                                           difference_type;
+
+    typedef unrolled_list_const_iterator<value_type, N>         self;
+    typedef unrolled_list_base_node<value_type>*                base_ptr;
+    typedef unrolled_list_node<value_type, N>*                  link_type;
+    typedef size_t                                              size_type;
+
+protected:
+    base_ptr node;
+    size_type index;
+
+    link_type get_node() const { return static_cast<link_type>(node); }
+
+public:
+    unrolled_list_const_iterator(base_ptr node = nullptr, size_type index = 0) : node(node), index(index) {}
+
+    bool operator==(const self& x) const { return node == x.node && index == x.index; }
+    bool operator!=(const self& x) const { return !operator==(x); }
+
+    reference operator*() const { return get_node()->data()[index]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++(){
+        if(++index == get_node()->count){
+            node = node->next;
+            index = 0;
+        }
+        return *this;
+    }
+
+    self operator++(int){
+        self ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    self& operator--(){
+        if(index == 0){
+            node = node->prev;
+            index = get_node()->count;
+        }
+        --index;
+        return *this;
+    }
+
+    self operator--(int){
+        self ret = *this;
+        --*this;
+        return ret;
+    }
+};
+
+
+template<typename value_type_, size_t N>
+class unrolled_list_iterator : public unrolled_list_const_iterator<value_type_, N>
+{
+public:
+    typedef GHYSTL::bidirectional_iterator_tag                  iterator_category;
+    typedef value_type_                                         value_type;
+    typedef value_type*                                         pointer;
+    typedef value_type&                                         reference;
+    typedef ptrdiff_t                                           difference_type;
+
+    typedef unrolled_list_iterator<value_type, N>               self;
+    typedef unrolled_list_const_iterator<value_type, N>         iterator_base;
+    typedef unrolled_list_base_node<value_type>*                base_ptr;
+    typedef unrolled_list_node<value_type, N>*                  link_type;
+    typedef size_t                                              size_type;
+
+    unrolled_list_iterator(base_ptr node = nullptr, size_type index = 0) : iterator_base(node, index) {}
+
+    bool operator==(const self& x) const { return this->node == x.node && this->index == x.index; }
+    bool operator!=(const self& x) const { return !(operator==(x)); }
+
+    reference operator*() const { return this->get_node()->data()[this->index]; }
+    pointer operator->() const { return &(operator*()); }
+
+    self& operator++(){
+        iterator_base::operator++();
+        return *this;
+    }
+
+    self operator++(int){
+        self ret = *this;
+        ++*this;
+        return ret;
+    }
+
+    self& operator--(){
+        iterator_base::operator--();
+        return *this;
+    }
+
+    self operator--(int){
+        self ret = *this;
+        --*this;
+        return ret;
+    }
+};
+
+
+/************************************************ 展开链表 unrolled_list ************************************************************/
+
+// 接口和 list 一样，但元素在结点内是连续存放的：
+//   插入时结点满了就对半分裂，删除后结点不到一半并且能和相邻结点放进一个结点就合并
+//   插入、删除只会让同一个结点(分裂、合并时还有相邻结点)里的迭代器失效，别的结点里的元素地址不变
+//   splice 以结点为单位搬动，不移动元素
+template <typename value_type_, size_t N = unrolled_list_node_size<value_type_>::value,
+          typename Alloc = GHYSTL::allocator<value_type_>>
+class unrolled_list : private GHYSTL::alloc_holder<typename GHYSTL::node_allocator<Alloc, unrolled_list_node<value_type_, N>>::type>
+{
+    static_assert(N >= 2, "unrolled_list node must hold at least two elements");
+
+public:
+    typedef value_type_             value_type;
+    typedef value_type*             pointer;
+    typedef const value_type*       const_pointer;
+    typedef value_type&             reference;
+    typedef const value_type&       const_reference;
+    typedef size_t                  size_type;
+    typedef ptrdiff_t               difference_type;
+
+    typedef unrolled_list<value_type_, N, Alloc>            self;
+    typedef unrolled_list_base_node<value_type>             base_node;
+    typedef base_node*                                      base_ptr;
+    typedef unrolled_list_node<value_type, N>*              link_type;
+
+    typedef Alloc           allocator_type;
+    typedef Alloc           data_alloc;
+    typedef typename GHYSTL::node_allocator<allocator_type, unrolled_list_node<value_type, N>>::type    node_alloc;
+    typedef GHYSTL::alloc_holder<node_alloc>                                                        holder_type;
+
+    typedef unrolled_list_iterator<value_type, N>           iterator;
+    typedef unrolled_list_const_iterator<value_type, N>     const_iterator;
+    typedef GHYSTL::reverse_iterator<iterator>              reverse_iterator;
+    typedef GHYSTL::reverse_iterator<const_iterator>        const_reverse_iterator;
+
+    static const size_type node_capacity = N;
+
+    allocator_type get_allocator() const { return allocator_type(this->get_alloc()); }
+
+private:
+    base_node root;         // 哨兵，只有 prev、next
+    size_type len;          // 元素个数
+    size_type nodes;        // 结点个数
+
+public:
+    /*-------------------------------------------- 构造函数 ------------------------------------------------*/
+    unrolled_list() { empty_init(); }
+
+    explicit unrolled_list(const allocator_type& a) : holder_type(node_alloc(a)) { empty_init(); }
+
+    template<typename Iter,
+                typename = typename GHYSTL::enable_if<is_iterator<Iter>::value, void>::type>
+    unrolled_list(Iter first, Iter last, const allocator_type& a = allocator_type()) : unrolled_list(a){
+        insert(end(), first, last);
+    }
+
+    explicit unrolled_list(const size_type n, const allocator_type& a = allocator_type()) : unrolled_list(a) { resize(n); }
+
+    unrolled_list(const size_type n, const value_type& val, const allocator_type& a = allocator_type()) : unrolled_list(a) {
+        insert(end(), n, val);
+    }
+
+    unrolled_list(const std::initializer_list<value_type>& lst, const allocator_type& a = allocator_type()) : unrolled_list(a) {
+        insert(end(), lst.begin(), lst.end());
+    }
+
+    unrolled_list(const self& x) : holder_type(x.get_alloc()) {
+        empty_init();
+        insert(end(), x.begin(), x.end());
+    }
+
+    // 哨兵在对象里，移动时把结点接到自己的哨兵上
+    unrolled_list(self&& x) noexcept : holder_type(x.get_alloc()) {
+        empty_init();
+        take(x);
+    }
+
+    self& operator=(const self& x){
+        if(this != &x)
+            assign(x.begin(), x.end());
+        return *this;
+    }
+
+    self& operator=(self&& x) noexcept {
+        if(this != &x){
+            clear();
+            take(x);
+        }
+        return *this;
+    }
+
+    self& operator=(const std::initializer_list<value_type>& lst){
+        assign(lst.begin(), lst.end());
+        return *this;
+    }
+
+    ~unrolled_list() { clear(); }
+
+public:
+    /*-------------------------------------------- 迭代器相关操作 ------------------------------------------------*/
+    bool empty() const { return len == 0; }
+    size_type size() const { return len; }
+    size_type node_count() const { return nodes; }
+    size_type max_size() const { return size_type(-1); }
+
+    iterator begin() noexcept { return iterator(root.next, 0); }
+    iterator end() noexcept { return iterator(&root, 0); }
+
+    // 哨兵在 const 对象里也要当作可以修改的结点
+    const_iterator begin() const noexcept { return const_iterator(root.next, 0); }
+    const_iterator end() const noexcept { return const_iterator(const_cast<base_ptr>(&root), 0); }
+
+    const_iterator cbegin() const noexcept { return begin(); }
+    const_iterator cend() const noexcept { return end(); }
+
+    reverse_iterator rbegin() noexcept { return reverse_iterator(end()); }
+    reverse_iterator rend() noexcept { return reverse_iterator(begin()); }
+
+    const_reverse_iterator rbegin() const noexcept { return const_reverse_iterator(end()); }
+    const_reverse_iterator rend() const noexcept { return const_reverse_iterator(begin()); }
+
+    reference front() { return *begin(); }
+    const_reference front() const { return *begin(); }
+
+    reference back() { return *(--end()); }
+    const_reference back() const { return *(--end()); }
+
+    // 按结点遍历：对每个结点的 [first, last) 调用 f，热循环里没有跨结点的判断
+    template<typename Func>
+    void for_each_segment(Func f){
+        for(base_ptr cur = root.next; cur != &root; cur = cur->next)
+            f(as_node(cur)->data(), as_node(cur)->data() + as_node(cur)->count);
+    }
+
+    template<typename Func>
+    void for_each_segment(Func f) const {
+        for(base_ptr cur = root.next; cur != &root; cur = cur->next)
+            f(static_cast<const value_type*>(as_node(cur)->data()),
+              static_cast<const value_type*>(as_node(cur)->data() + as_node(cur)->count));
+    }
+
+public:
+    /*-------------------------------------------- 插入删除 push、pop、emplace ------------------------------------------------*/
+    void push_front(const value_type& val) { emplace(begin(), val); }
+    void push_front(value_type&& val) { emplace(begin(), std::move(val)); }
+
+    void push_back(const value_type& val) { emplace(end(), val); }
+    void push_back(value_type&& val) { emplace(end(), std::move(val)); }
+
+    template<typename ... types>
+    void emplace_front(types && ... args) { emplace(begin(), std::forward<types>(args)...); }
+
+    template<typename ... types>
+    void emplace_back(types && ... args) { emplace(end(), std::forward<types>(args)...); }
+
+    template<typename ... types>
+    iterator emplace(const_iterator pos, types && ... args);
+
+    void pop_front() { erase(begin()); }
+    void pop_back() { erase(--end()); }
+
+    iterator insert(const_iterator pos, const value_type& val) { return emplace(pos, val); }
+    iterator insert(const_iterator pos, value_type&& val) { return emplace(pos, std::move(val)); }
+
+    // 插入多个元素时逐个插入，返回的迭代器在插完后重新定位(插入过程中可能分裂结点)
+    iterator insert(const_iterator pos, size_type n, const value_type& val){
+        const size_type off = offset_of(pos);
+        for(size_type i = 0; i != n; ++i)
+            pos = emplace(pos, val), ++pos;
+        return locate(off);
+    }
+
+    template<typename Iter>
+    typename enable_if<is_iterator<Iter>::value, iterator>::type
+    insert(const_iterator pos, Iter first, Iter last){
+        const size_type off = offset_of(pos);
+        for(; first != last; ++first)
+            pos = emplace(pos, *first), ++pos;
+        return locate(off);
+    }
+
+    iterator insert(const_iterator pos, const std::initializer_list<value_type>& lst){
+        return insert(pos, lst.begin(), lst.end());
+    }
+
+    iterator erase(const_iterator pos){
+        GHYSTL_DEBUG(pos != cend());
+        return erase_in_node(pos.get_node(), pos.index, 1);
+    }
+
+    // 整段落在区间里的结点直接释放，不逐个移动元素
+    iterator erase(const_iterator first, const_iterator last){
+        size_type n = GHYSTL::distance(first, last);
+        iterator cur(first.node, first.index);
+        while(n != 0){
+            link_type p = cur.get_node();
+            const size_type k = p->count - cur.index < n ? p->count - cur.index : n;
+            cur = erase_in_node(p, cur.index, k);
+            n -= k;
+        }
+        return cur;
+    }
+
+    void clear();
+
+    void resize(size_type new_size){
+        while(len < new_size) emplace_back();
+        if(len > new_size) erase(locate(new_size), end());
+    }
+
+    void resize(size_type new_size, const value_type& val){
+        if(len < new_size) insert(end(), new_size - len, val);
+        else if(len > new_size) erase(locate(new_size), end());
+    }
+
+    void swap(self& x) noexcept {
+        self tmp(std::move(x));
+        x.take(*this);
+        take(tmp);
+        this->swap_alloc(x);
+    }
+
+    /*-------------------------------------------- 分配操作 assign ------------------------------------------------*/
+    template<typename Iter>
+    typename enable_if<is_iterator<Iter>::value, void>::type
+    assign(Iter first, Iter last){
+        iterator bg = begin();
+        for(; bg != end() && first != last; ++bg, ++first)
+            *bg = *first;
+        if(first != last) insert(end(), first, last);
+        else erase(bg, end());
+    }
+
+    void assign(const std::initializer_list<value_type>& lst){
+        assign(lst.begin(), lst.end());
+    }
+
+    void assign(size_type n, const value_type& val){
+        iterator bg = begin();
+        for(; bg != end() && n != 0; ++bg, --n)
+            *bg = val;
+        if(n != 0) insert(end(), n, val);
+        else erase(bg, end());
+    }
+
+    /*-------------------------------------------- 删除满足条件的元素 ------------------------------------------------*/
+    void remove(const value_type& val){
+        remove_if([&val](const value_type& x) { return x == val; });
+    }
+
+    // 每个结点内把留下的元素往前挪，最后一次性截掉尾部，结点变空就释放
+    template<typename Pred>
+    void remove_if(Pred pred);
+
+    /*--------------------------------------------  链接 splice ------------------------------------------------*/
+    // 把 x 的所有结点接到 pos 前面，pos 在结点中间时先把这个结点从 pos 处拆开
+    void splice(const_iterator pos, self& x){
+        if(this == &x || x.empty()) return;
+        base_ptr at = split_at(pos);
+        transfer(at, x.root.next, &x.root);
+        len += x.len;
+        nodes += x.nodes;
+        x.len = 0;
+        x.nodes = 0;
+    }
+
+    void splice(const_iterator pos, self&& x) { splice(pos, (self&) x); }
+
+    // 把 x 中 it 所在的整个结点接到 pos 前面，返回这个结点第一个元素的迭代器
+    iterator splice_node(const_iterator pos, self& x, const_iterator it){
+        GHYSTL_DEBUG(it != x.cend());
+        base_ptr moved = it.node;
+        base_ptr at = split_at(pos);
+        if(at == moved) // pos 正好在这个结点的开头，不用动
+            return iterator(moved, 0);
+        if(this != &x){
+            const size_type n = as_node(moved)->count;
+            len += n;
+            x.len -= n;
+            ++nodes;
+            --x.nodes;
+        }
+        transfer(at, moved, moved->next);
+        return iterator(moved, 0);
+    }
+
+private:
+    /*-------------------------------------------- 内部操作 ------------------------------------------------*/
+    static link_type as_node(base_ptr p) { return static_cast<link_type>(p); }
+    static link_type as_node(const base_node* p) { return static_cast<link_type>(const_cast<base_ptr>(p)); }
+
+    void empty_init(){
+        root.prev = root.next = &root;
+        len = 0;
+        nodes = 0;
+    }
+
+    void take(self& x){
+        if(x.empty()) return;
+        root.next = x.root.next;
+        root.prev = x.root.prev;
+        root.next->prev = &root;
+        root.prev->next = &root;
+        len = x.len;
+        nodes = x.nodes;
+        x.empty_init();
+    }
+
+    // 新结点挂在 pos 前面
+    link_type create_node(base_ptr pos){
+        link_type p = this->get_alloc().allocate();
+        p->count = 0;
+        p->next = pos;
+        p->prev = pos->prev;
+        pos->prev->next = p;
+        pos->prev = p;
+        ++nodes;
+        return p;
+    }
+
+    // 结点里已经没有元素了
+    void free_node(link_type p){
+        p->prev->next = p->next;
+        p->next->prev = p->prev;
+        this->get_alloc().deallocate(p);
+        --nodes;
+    }
+
+    // [first, last) 的结点移到 pos 前面
+    static void transfer(base_ptr pos, base_ptr first, base_ptr last){
+        if(pos == last) return;
+        base_ptr tail = last->prev;
+        first->prev->next = last;
+        last->prev = first->prev;
+
+        tail->next = pos;
+        first->prev = pos->prev;
+        pos->prev->next = first;
+        pos->prev = tail;
+    }
+
+    // 把 from 的 [idx, count) 移到 to 的末尾，to 要放得下
+    static void move_tail(link_type from, size_type idx, link_type to){
+        value_type* src = from->data();
+        value_type* dest = to->data() + to->count;
+        size_type i = idx;
+        try{
+            for(; i != from->count; ++i, ++dest)
+                data_alloc::construct(dest, std::move(src[i]));
+        }
+        catch(...){
+            data_alloc::destroy(to->data() + to->count, dest);
+            throw;
+        }
+        data_alloc::destroy(src + idx, src + from->count);
+        to->count += from->count - idx;
+        from->count = idx;
+    }
+
+    // 从 idx 处把结点拆成两个，返回后一半所在的结点；idx == 0 时不拆
+    base_ptr split_at(const_iterator pos){
+        if(pos.index == 0) return pos.node;
+        link_type p = pos.get_node();
+        link_type q = create_node(p->next);
+        try{
+            move_tail(p, pos.index, q);
+        }
+        catch(...){
+            free_node(q);
+            throw;
+        }
+        return q;
+    }
+
+    template<typename ... types>
+    void emplace_in_node(link_type p, size_type idx, types && ... args);
+
+    iterator erase_in_node(link_type p, size_type idx, size_type n);
+
+    // 第 off 个元素的迭代器，按结点跳
+    iterator locate(size_type off){
+        base_ptr cur = root.next;
+        for(; cur != &root && off >= as_node(cur)->count; cur = cur->next)
+            off -= as_node(cur)->count;
+        return iterator(cur, cur == &root ? 0 : off);
+    }
+
+    size_type offset_of(const_iterator pos) const {
+        size_type off = pos.index;
+        for(base_ptr cur = root.next; cur != pos.node; cur = cur->next)
+            off += as_node(cur)->count;
+        return off;
+    }
+};
+
+
+/*-------------------------------------------- 插入 ------------------------------------------------*/
+
+// 插入位置所在结点满了：在开头插入并且前一个结点有空位就放到前一个结点末尾；
+// 在开头或末尾插入就新开一个结点；否则对半分裂后插进对应的一半
+template<typename value_type, size_t N, typename alloc>
+template<typename ... types>
+typename unrolled_list<value_type, N, alloc>::iterator
+unrolled_list<value_type, N, alloc>::emplace(const_iterator pos, types && ... args){
+    base_ptr prev = pos.node->prev;
+    const bool prev_has_room = prev != &root && as_node(prev)->count < N;
+
+    if(pos.index == 0 && prev_has_room){ // 包括在末尾插入
+        link_type p = as_node(prev);
+        const size_type idx = p->count;
+        emplace_in_node(p, idx, std::forward<types>(args)...);
+        ++len;
+        return iterator(p, idx);
+    }
+
+    if(pos.node == &root || (pos.index == 0 && as_node(pos.node)->count == N)){
+        link_type p = create_node(pos.node);
+        try{
+            emplace_in_node(p, 0, std::forward<types>(args)...);
+        }
+        catch(...){
+            free_node(p);
+            throw;
+        }
+        ++len;
+        return iterator(p, 0);
+    }
+
+    link_type p = pos.get_node();
+    size_type idx = pos.index;
+    if(p->count < N){
+        emplace_in_node(p, idx, std::forward<types>(args)...);
+        ++len;
+        return iterator(p, idx);
+    }
+
+    // 参数可能引用要被搬走的那一半元素，先构造出来
+    value_type tmp(std::forward<types>(args)...);
+    base_ptr q = split_at(const_iterator(p, N / 2));
+    if(idx > N / 2){
+        p = as_node(q);
+        idx -= N / 2;
+    }
+    emplace_in_node(p, idx, std::move(tmp));
+    ++len;
+    return iterator(p, idx);
+}
+
+// 结点有空位，把 [idx, count) 后移一格，在 idx 处放新元素
+// 参数可能引用结点里的元素，不在末尾插入时先构造出临时对象再移动
+template<typename value_type, size_t N, typename alloc>
+template<typename ... types>
+void unrolled_list<value_type, N, alloc>::emplace_in_node(link_type p, size_type idx, types && ... args){
+    value_type* d = p->data();
+    if(idx == p->count){
+        data_alloc::construct(d + idx, std::forward<types>(args)...);
+        ++p->count;
+        return;
+    }
+    value_type tmp(std::forward<types>(args)...);
+    data_alloc::construct(d + p->count, std::move(d[p->count - 1]));
+    ++p->count;
+    for(size_type i = p->count - 2; i != idx; --i)
+        d[i] = std::move(d[i - 1]);
+    d[idx] = std::move(tmp);
+}
+
+
+/*-------------------------------------------- 删除 ------------------------------------------------*/
+
+// 删除 p 中 [idx, idx + n)，结点变空就释放；
+// 剩下不到一半时和后一个(或前一个)结点合并，返回被删元素后面那个元素的迭代器
+template<typename value_type, size_t N, typename alloc>
+typename unrolled_list<value_type, N, alloc>::iterator
+unrolled_list<value_type, N, alloc>::erase_in_node(link_type p, size_type idx, size_type n){
+    value_type* d = p->data();
+    for(size_type i = idx + n; i != p->count; ++i)
+        d[i - n] = std::move(d[i]);
+    data_alloc::destroy(d + p->count - n, d + p->count);
+    p->count -= n;
+    len -= n;
+
+    if(p->count == 0){
+        base_ptr next = p->next;
+        free_node(p);
+        return iterator(next, 0);
+    }
+
+    if(p->count < N / 2){
+        base_ptr next = p->next;
+        base_ptr prev = p->prev;
+        if(next != &root && p->count + as_node(next)->count <= N){
+            move_tail(as_node(next), 0, p);
+            free_node(as_node(next));
+        }
+        else if(prev != &root && p->count + as_node(prev)->count <= N){
+            link_type q = as_node(prev);
+            const size_type base = q->count;
+            move_tail(p, 0, q);
+            free_node(p);
+            p = q;
+            idx += base;
+        }
+    }
+
+    if(idx == p->count)
+        return iterator(p->next, 0);
+    return iterator(p, idx);
+}
+
+template<typename value_type, size_t N, typename alloc>
+void unrolled_list<value_type, N, alloc>::clear(){
+    base_ptr cur = root.next;
+    while(cur != &root){
+        base_ptr next = cur->next;
+        link_type p = as_node(cur);
+        data_alloc::destroy(p->data(), p->data() + p->count);
+        this->get_alloc().deallocate(p);
+        cur = next;
+    }
+    empty_init();
+}
+
+template<typename value_type, size_t N, typename alloc>
+template<typename Pred>
+void unrolled_list<value_type, N, alloc>::remove_if(Pred pred){
+    base_ptr cur = root.next;
+    while(cur != &root){
+        base_ptr next = cur->next;
+        link_type p = as_node(cur);
+        value_type* d = p->data();
+        size_type kept = 0;
+        for(size_type i = 0; i != p->count; ++i){
+            if(pred(d[i])) continue;
+            if(kept != i) d[kept] = std::move(d[i]);
+            ++kept;
+        }
+        data_alloc::destroy(d + kept, d + p->count);
+        len -= p->count - kept;
+        p->count = kept;
+        if(kept == 0) free_node(p);
+        cur = next;
+    }
+}
+
+
+/*-------------------------------------------- 比较 ------------------------------------------------*/
+template<typename value_type, size_t N, typename alloc>
+inline bool operator==(const GHYSTL::unrolled_list<value_type, N, alloc>& left,
+                       const GHYSTL::unrolled_list<value_type, N, alloc>& right){
+    return left.size() == right.size() && GHYSTL::equal(left.begin(), left.end(), right.begin(), right.end());
+}
+
+template<typename value_type, size_t N, typename alloc>
+inline bool operator!=(const GHYSTL::unrolled_list<value_type, N, alloc>& left,
+                       const GHYSTL::unrolled_list<value_type, N, alloc>& right){
+    return !(left == right);
+}
+
+template<typename value_type, size_t N, typename alloc>
+inline void swap(GHYSTL::unrolled_list<value_type, N, alloc>& left,
+                 GHYSTL::unrolled_list<value_type, N, alloc>& right) noexcept {
+    left.swap(right);
+}
+
+}
+
+#endif
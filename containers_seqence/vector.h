@@ -194,8 +194,9 @@ namespace GHYSTL{
 
     // --------------- vector ---------------------------------
 
-    template<class T, class Alloc = GHYSTL::allocator<T>>
-    class vector
+    // Growth 是扩容策略，决定空间不够时新的容量，见 allocator.h 里的 growth_double、growth_half、growth_size_class
+    template<class T, class Alloc = GHYSTL::allocator<T>, class Growth = GHYSTL::growth_double>
+    class vector : private GHYSTL::alloc_holder<Alloc>
     {
     public:
         typedef T           value_type;
@@ -211,10 +212,25 @@ namespace GHYSTL{
         typedef GHYSTL::reverse_iterator<iterator>          reverse_iterator;
         typedef GHYSTL::reverse_iterator<const_iterator>    const_reverse_iterator;
 
-    private:
-        typedef vector<value_type, Alloc>   self;
         typedef Alloc                       allocator_type;
+        typedef Growth                      growth_policy;
+
+    protected: // small_vector 要直接管理这几个指针
+        typedef vector<value_type, Alloc, Growth>   self;
         typedef Alloc                       alloc;
+        typedef GHYSTL::alloc_holder<Alloc> holder_type;
+
+        // 元素可以按字节搬动、分配器又提供 reallocate 时，扩容直接 reallocate，
+        // 大块的空间由 realloc 原地扩展或者重新映射，不用整块复制
+        enum{
+            use_reallocate = GHYSTL::is_trivially_relocatable<T>::value && GHYSTL::has_reallocate<Alloc>::value
+        };
+
+        // 换到新空间时旧元素怎么搬：能按字节搬的整块 memcpy，移动构造不抛异常的逐个移动，否则只能复制
+        enum{
+            use_memcpy = GHYSTL::is_trivially_relocatable<T>::value,
+            use_move = std::is_nothrow_move_constructible<T>::value
+        };
 
         pointer first;     //目前使用空间头
         pointer last;    //目前使用空间尾
@@ -225,21 +241,24 @@ namespace GHYSTL{
 
         vector():first(nullptr), last(nullptr), end_storage(nullptr){};
 
+        // 使用指定的分配器实例，之后所有的空间都从这个实例上分配
+        explicit vector(const allocator_type& a) : holder_type(a), first(nullptr), last(nullptr), end_storage(nullptr){}
+
         // 调用默认构造函数，对 first， last， end_storage初始化 
-        explicit vector(const size_type n) : vector() { 
-            first = alloc::allocate(n);
+        explicit vector(const size_type n, const allocator_type& a = allocator_type()) : vector(a) { 
+            first = this->get_alloc().allocate(n);
             alloc::construct(first, n);
             last = end_storage = first + n;
         }
 
-        vector(const size_type n, const value_type &val) : vector() { 
+        vector(const size_type n, const value_type &val, const allocator_type& a = allocator_type()) : vector(a) { 
             // 用 n 个 val 初始化
-            first = alloc::allocate(n);
+            first = this->get_alloc().allocate(n);
             end_storage = last = alloc::copy_construct(first, n, val);
         }
 
 
-        vector(const std::initializer_list<T> &lst) : vector(lst.begin(), lst.end()){
+        vector(const std::initializer_list<T> &lst, const allocator_type& a = allocator_type()) : vector(lst.begin(), lst.end(), a){
             // 使用初始化列表 对 vector 进行初始化
         }
         
@@ -248,18 +267,19 @@ namespace GHYSTL{
         // 上面这个函数调用它的时候，就会链接失败（编译期间不会报错）
         template<typename Iter, 
                 typename = typename GHYSTL::enable_if<is_iterator<Iter>::value, void>::type>
-        vector(Iter bg, Iter ed) : vector() {
+        vector(Iter bg, Iter ed, const allocator_type& a = allocator_type()) : vector(a) {
             // 为迭代器分配元素
             assign_imple(bg, ed, GHYSTL::iterator_category(bg));
         }
 
-        vector(const self& x){ // 拷贝构造函数
-            first = alloc::allocate(x.size());
+        vector(const self& x) : holder_type(x.get_alloc()){ // 拷贝构造函数
+            first = this->get_alloc().allocate(x.size());
             last = alloc::copy_construct(x.first, x.last, first);
             end_storage = first + x.size();
         }
 
-        vector(self&& x) noexcept : first(x.first), last(x.last), end_storage(x.end_storage){// 移动构造函数
+        vector(self&& x) noexcept : holder_type(x.get_alloc()), 
+                                    first(x.first), last(x.last), end_storage(x.end_storage){// 移动构造函数
             x.first = x.last = x.end_storage = nullptr;
         }
 
@@ -273,7 +293,7 @@ namespace GHYSTL{
 
         ~vector(){
             alloc::destroy(first, last);
-            alloc::deallocate(first);
+            this->get_alloc().deallocate(first, capacity());
         }
 
         /*------------------------ ---------------- 常规函数  -------------------------------------------*/
@@ -312,12 +332,8 @@ namespace GHYSTL{
         }
 
         void shrink_to_fit(){
-            if(end_storage != last && !empty()){
-                size_t len = this->size();
-                pointer ptr = alloc::allocate(len);
-                pointer new_last = alloc::copy_construct(first, last, ptr);
-                deallocate_and_update_ptr(ptr, new_last, len);
-            }
+            if(end_storage != last && !empty())
+                reallocate_storage(size());
         }
 
         // 与另一个 vector 交换
@@ -326,19 +342,17 @@ namespace GHYSTL{
                 GHYSTL::swap(first, x.first);
                 GHYSTL::swap(last, x.last);
                 GHYSTL::swap(end_storage, x.end_storage);
+                this->swap_alloc(x);
             }
         }
 
         allocator_type get_allocator() const {
-            return allocator_type();
+            return this->get_alloc();
         }
 
         void reserve(const size_type n){ // 扩容
-            if(n > capacity()){
-                pointer ptr = alloc::allocate(n);
-                pointer new_last = alloc::copy_construct(first, last, ptr);
-                deallocate_and_update_ptr(ptr, new_last, n);
-            }
+            if(n > capacity())
+                reallocate_storage(n);
         }
     
     public:
@@ -430,10 +444,9 @@ namespace GHYSTL{
                 alloc::construct(last, first + n);
                 last = last + n;
             }else{
-                pointer ptr = alloc::allocate(n);
-                alloc::copy_construct(first, last, ptr);
-                alloc::construct(ptr + size(), ptr + n);
-                deallocate_and_update_ptr(ptr, ptr + n, n);
+                reallocate_storage(n);
+                alloc::construct(last, first + n);
+                last = first + n;
             }
         }
         
@@ -445,13 +458,39 @@ namespace GHYSTL{
                 alloc::copy_construct(last, first + n, val);
                 last = first + n;
             }else{
-                pointer ptr = alloc::allocate(n);
-                alloc::copy_construct(first, last, ptr);
-                alloc::copy_construct(ptr + size(), ptr + n, val);
-                deallocate_and_update_ptr(ptr, ptr + n, n);
+                reallocate_storage(n);
+                alloc::copy_construct(last, first + n, val);
+                last = first + n;
             }
         }
 
+        // 和 resize(n) 一样，但新增的元素只做默认初始化
+        // 元素马上要被 read() 之类的函数整体覆盖时，省掉一遍清零
+        void resize_default_init(const size_type n){
+            if(n <= size()){
+                alloc::destroy(first + n, last);
+                last = first + n;
+            }else{
+                if(n > capacity())
+                    reallocate_storage(n);
+                last = alloc::default_construct(last, first + n);
+            }
+        }
+
+        // 在尾部准备好 n 个未初始化的位置，返回第一个位置，size() 不变
+        // 调用者在 [p, p + n) 上构造(POD 类型直接写入)元素后，调用 commit_append 把它们计入 size()
+        pointer append_uninitialized(const size_type n){
+            if(static_cast<size_type>(end_storage - last) < n)
+                reallocate_storage(grow_capacity(size() + n));
+            return last;
+        }
+
+        // 把 append_uninitialized 准备的位置中前 n 个计入 size()，这 n 个元素必须已经构造好
+        void commit_append(const size_type n){
+            GHYSTL_DEBUG(n <= static_cast<size_type>(end_storage - last));
+            last += n;
+        }
+
         iterator insert(iterator pos, value_type&& val){
             return emplace(pos, std::move(val));
         }
@@ -463,7 +502,7 @@ namespace GHYSTL{
         }
 
         template<typename Iter>
-        typename enable_if<is_iterator<Iter>::value, iterator>::type insert(Iter pos, Iter bg, Iter ed){
+        typename enable_if<is_iterator<Iter>::value, iterator>::type insert(iterator pos, Iter bg, Iter ed){
             return insert_imple(pos, bg, ed, 
                                 typename GHYSTL::iterator_traits<Iter>::iterator_category());
         }
@@ -473,13 +512,7 @@ namespace GHYSTL{
         }
 
         void push_back(const value_type& val){
-            if(last == end_storage){
-                const size_type len = size() ? 2 * size() : 1;
-                auto ptr = alloc::allocate(len);
-                auto new_last = alloc::copy_construct(first, last, ptr);
-                deallocate_and_update_ptr(ptr, new_last, len);
-            }
-            alloc::copy_construct(last++, val);
+            emplace_back(val);
         }
 
         void push_back(value_type && val){
@@ -491,20 +524,38 @@ namespace GHYSTL{
         template<typename ...types>
         void emplace_back(types && ... args){
             if(last == end_storage){
-                const size_type len = size() ? 2 * size() : 1;
-                auto ptr = alloc::allocate(len);
-                auto new_last = alloc::copy_construct(first, last, ptr);
-                deallocate_and_update_ptr(ptr, new_last, len);
+                grow_and_emplace_back(GHYSTL::bool_type<use_reallocate>(), std::forward<types>(args)...);
+                return;
             }
-            alloc::construct(last++, std::forward<types>(args)...);
+            alloc::construct(last, std::forward<types>(args)...); // 构造成功后才移动 last
+            ++last;
         }
 
         template<typename ... types>
         iterator emplace(iterator pos, types && ... args){
-            size_type off = pos - begin();
-            iterator middle = --end();
-            emplace_back(std::forward<types>(args)...);
-            GHYSTL::rotate(begin() + off, middle, end());
+            const size_type off = pos - begin();
+            if(last == end_storage){
+                const size_type len = grow_capacity(size() + 1);
+                pointer ptr = this->get_alloc().allocate(len);
+                try{
+                    // 先在新空间里构造，args 引用的是容器里的元素也没关系
+                    alloc::construct(ptr + off, std::forward<types>(args)...);
+                }
+                catch(...){
+                    this->get_alloc().deallocate(ptr, len);
+                    throw;
+                }
+                relocate_around(ptr, off, 1, len);
+            }
+            else if(first + off == last){
+                alloc::construct(last, std::forward<types>(args)...);
+                ++last;
+            }
+            else{
+                // args 可能引用容器里的元素，先构造出来再后移
+                value_type tmp(std::forward<types>(args)...);
+                emplace_imple(first + off, std::move(tmp), GHYSTL::bool_type<use_memcpy>());
+            }
             return (begin() + off);
         }
 
@@ -520,8 +571,8 @@ namespace GHYSTL{
         void assign_imple(Iter bg, Iter ed, GHYSTL::forward_iterator_tag){
             const size_t len = GHYSTL::distance(bg, ed);
             if(capacity() < len){
-                alloc::deallocate(first, capacity());
-                first = alloc::allocate(len);
+                this->get_alloc().deallocate(first, capacity());
+                first = this->get_alloc().allocate(len);
                 end_storage = first + len;
             }
 
@@ -531,37 +582,281 @@ namespace GHYSTL{
         template<typename Iter>
         iterator insert_imple(iterator pos, Iter bg, Iter ed, GHYSTL::input_iterator_tag){
             const size_type off = pos - begin();
-            const size_type old_size = size();
-            for(; bg != ed; ++bg)
-                push_back(*bg);
-            GHYSTL::rotate(begin() + off, begin() + old_size, end());
+            if(first + off == last){
+                for(; bg != ed; ++bg)
+                    emplace_back(*bg);
+            }
+            else{
+                // 输入迭代器只能走一遍，先放进临时的 vector 里数出个数，原来的尾部只后移一次
+                GHYSTL::vector<value_type> tmp(bg, ed);
+                insert_imple(pos, tmp.begin(), tmp.end(), GHYSTL::forward_iterator_tag());
+            }
             return (begin() + off);
         }
 
         template<typename Iter>
-        iterator inset_imple(iterator pos, Iter bg, Iter ed, GHYSTL::forward_iterator_tag){
-            const size_type off = capacity();
+        iterator insert_imple(iterator pos, Iter bg, Iter ed, GHYSTL::forward_iterator_tag){
+            const size_type off = pos - begin();
             const size_type count = GHYSTL::distance(bg, ed);
+            if(count == 0) return pos;
 
-            if(count <= static_cast<size_type>(capacity() - last())){
-                GHYSTL::copy_backward(pos, end(), last + count);
-                last += count;
-                GHYSTL::copy(bg, ed, pos);
+            if(count <= static_cast<size_type>(end_storage - last)){
+                insert_in_place(first + off, bg, count, GHYSTL::bool_type<use_memcpy>());
             }else{
-                const size_type old_size = capacity();
-                const size_type len = old_size + (old_size > count ? old_size : count);
-                pointer ptr = alloc::allocate(len);
-                pointer new_last = alloc::copy_construct(first, pos, ptr);
-                new_last = alloc::copy_construct(bg, ed, new_last);
-                new_last = alloc::copy_construct(first + off, last, new_last);
-                deallocate_and_update_ptr(ptr, new_last, len);
+                const size_type len = grow_capacity(size() + count);
+                pointer ptr = this->get_alloc().allocate(len);
+                try{
+                    copy_or_rollback(bg, ed, ptr + off);
+                }
+                catch(...){
+                    this->get_alloc().deallocate(ptr, len);
+                    throw;
+                }
+                relocate_around(ptr, off, count, len);
             }
             return (begin() + off);
         }
 
+        // 空间足够时的插入：[pos, last) 整体后移 count 个位置，每个元素只移动一次，新元素直接构造在空出来的位置上
+        // 可以按字节搬动的元素用 memmove 后移，空出来的位置全是未初始化的空间
+        template<typename Iter>
+        void insert_in_place(pointer pos, Iter bg, const size_type count, GHYSTL::true_type){
+            const size_type after = last - pos;
+            std::memmove(static_cast<void*>(pos + count), static_cast<const void*>(pos), sizeof(value_type) * after);
+            pointer cur = pos;
+            try{
+                for(; cur != pos + count; ++cur, ++bg)
+                    alloc::construct(cur, *bg);
+            }
+            catch(...){
+                alloc::destroy(pos, cur);
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + count), sizeof(value_type) * after);
+                throw;
+            }
+            last += count;
+        }
+
+        // 其余的元素：落到未初始化空间的那部分构造，原来 last 之前的位置赋值
+        // 每构造好一个元素 last 才后移一位，中途抛异常时 [first, last) 里都是构造好的元素
+        template<typename Iter>
+        void insert_in_place(pointer pos, Iter bg, const size_type count, GHYSTL::false_type){
+            const size_type after = last - pos;
+            if(after >= count){
+                open_gap(pos, count);
+                for(pointer cur = pos; cur != pos + count; ++cur, ++bg)
+                    *cur = *bg;
+            }
+            else{
+                // 插入点后面的元素比插入的少：超出原来 last 的新元素先构造，再把 [pos, last) 移到它们后面
+                pointer old_last = last;
+                Iter mid = bg;
+                GHYSTL::advance(mid, after);
+                for(size_type i = after; i != count; ++i, ++mid){
+                    alloc::construct(last, *mid);
+                    ++last;
+                }
+                for(pointer src = pos; src != old_last; ++src){
+                    alloc::construct(last, std::move(*src));
+                    ++last;
+                }
+                for(pointer cur = pos; cur != old_last; ++cur, ++bg)
+                    *cur = *bg;
+            }
+        }
+
+        void emplace_imple(pointer pos, value_type&& val, GHYSTL::true_type){
+            std::memmove(static_cast<void*>(pos + 1), static_cast<const void*>(pos), sizeof(value_type) * (last - pos));
+            try{
+                alloc::construct(pos, std::move(val));
+            }
+            catch(...){
+                std::memmove(static_cast<void*>(pos), static_cast<const void*>(pos + 1), sizeof(value_type) * (last - pos));
+                throw;
+            }
+            ++last;
+        }
+
+        void emplace_imple(pointer pos, value_type&& val, GHYSTL::false_type){
+            open_gap(pos, 1);
+            *pos = std::move(val);
+        }
+
+        // [pos, last) 后移 count 个位置，要求 last - pos >= count
+        // 最后 count 个元素移动构造到 last 之后，每构造好一个 last 后移一位，其余的往后移动赋值
+        // 调用之后 [pos, pos + count) 是被移走了值的元素，由调用者赋值
+        void open_gap(pointer pos, const size_type count){
+            pointer old_last = last;
+            pointer split = old_last - count;
+            for(pointer src = split; src != old_last; ++src){
+                alloc::construct(last, std::move(*src));
+                ++last;
+            }
+            for(pointer src = split, dest = old_last; src != pos; )
+                *--dest = std::move(*--src);
+        }
+
+        // 扩容时的插入：插入的 count 个元素已经构造在新空间 ptr + off 上，原来的元素分成两段搬到它们前后
+        // 搬动失败时析构插入的元素、释放新空间，原来的元素不受影响
+        void relocate_around(pointer ptr, const size_type off, const size_type count, const size_type len){
+            pointer new_last;
+            try{
+                new_last = relocate_split(ptr, off, count, GHYSTL::bool_type<use_memcpy || use_move>());
+            }
+            catch(...){
+                alloc::destroy(ptr + off, ptr + off + count);
+                this->get_alloc().deallocate(ptr, len);
+                throw;
+            }
+            replace_storage(ptr, new_last, len);
+        }
+
+        // 按字节搬动或者移动构造，不会抛异常
+        pointer relocate_split(pointer ptr, const size_type off, const size_type count, GHYSTL::true_type){
+            relocate(first, first + off, ptr);
+            return relocate(first + off, last, ptr + off + count);
+        }
+
+        // 只能复制时，两段都复制完才析构原来的元素
+        // 每一段复制失败时自己析构已经复制的部分，第二段失败时再析构第一段
+        pointer relocate_split(pointer ptr, const size_type off, const size_type count, GHYSTL::false_type){
+            pointer mid = copy_or_rollback(first, first + off, ptr);
+            pointer new_last;
+            try{
+                new_last = copy_or_rollback(first + off, last, ptr + off + count);
+            }
+            catch(...){
+                alloc::destroy(ptr, mid);
+                throw;
+            }
+            alloc::destroy(first, last);
+            return new_last;
+        }
+
+        // 至少要放下 n 个元素时，按扩容策略算出新的容量
+        size_type grow_capacity(const size_type n) const {
+            return Growth::new_capacity(this->get_alloc(), capacity(), n);
+        }
+
+        // 扩容时 args 可能引用容器里的元素，必须在释放原空间之前用掉
+        // 原地扩容：元素按字节搬动，先把新元素构造成临时对象
+        template<typename ...types>
+        void grow_and_emplace_back(GHYSTL::true_type, types && ... args){
+            value_type tmp(std::forward<types>(args)...);
+            reallocate_storage(grow_capacity(size() + 1));
+            alloc::construct(last, std::move(tmp));
+            ++last;
+        }
+
+        // 先在新空间里构造新元素，再搬原来的元素
+        template<typename ...types>
+        void grow_and_emplace_back(GHYSTL::false_type, types && ... args){
+            const size_type off = size();
+            const size_type len = grow_capacity(off + 1);
+            pointer ptr = this->get_alloc().allocate(len);
+            try{
+                alloc::construct(ptr + off, std::forward<types>(args)...);
+            }
+            catch(...){
+                this->get_alloc().deallocate(ptr, len);
+                throw;
+            }
+            relocate_around(ptr, off, 1, len);
+        }
+
+        // 把容量调整为 n (n >= size())，已有的元素搬到新空间
+        void reallocate_storage(const size_type n){
+            reallocate_storage_imple(n, GHYSTL::bool_type<use_reallocate>());
+        }
+
+        void reallocate_storage_imple(const size_type n, GHYSTL::true_type){
+            const size_type len = size();
+            first = this->get_alloc().reallocate(first, capacity(), n);
+            last = first + len;
+            end_storage = first + n;
+        }
+
+        void reallocate_storage_imple(const size_type n, GHYSTL::false_type){
+            pointer ptr = this->get_alloc().allocate(n);
+            pointer new_last;
+            try{
+                new_last = relocate(first, last, ptr);
+            }
+            catch(...){
+                this->get_alloc().deallocate(ptr, n);
+                throw;
+            }
+            replace_storage(ptr, new_last, n);
+        }
+
+        // 把 [bg, ed) 的元素搬到 dest 开始的未初始化空间，返回新空间的尾后位置
+        // 搬完之后原来的元素已经析构(或者按字节搬走了不需要析构)，原空间只剩下释放
+        static pointer relocate(pointer bg, pointer ed, pointer dest){
+            return relocate_imple(bg, ed, dest, GHYSTL::bool_type<use_memcpy>());
+        }
+
+        static pointer relocate_imple(pointer bg, pointer ed, pointer dest, GHYSTL::true_type){
+            if(bg != ed)
+                std::memcpy(static_cast<void*>(dest), static_cast<const void*>(bg), sizeof(value_type) * (ed - bg));
+            return dest + (ed - bg);
+        }
+
+        static pointer relocate_imple(pointer bg, pointer ed, pointer dest, GHYSTL::false_type){
+            pointer new_last = relocate_move(bg, ed, dest, GHYSTL::bool_type<use_move>());
+            alloc::destroy(bg, ed);
+            return new_last;
+        }
+
+        static pointer relocate_move(pointer bg, pointer ed, pointer dest, GHYSTL::true_type){
+            for(; bg != ed; ++bg, ++dest)
+                alloc::construct(dest, std::move(*bg));
+            return dest;
+        }
+
+        // 移动可能抛异常，复制保证失败时原来的元素不受影响
+        static pointer relocate_move(pointer bg, pointer ed, pointer dest, GHYSTL::false_type){
+            return copy_or_rollback(bg, ed, dest);
+        }
+
+        // 把 [bg, ed) 复制构造到 dest 开始的未初始化空间
+        // 中途抛异常时析构已经构造好的部分再抛出，dest 上不留下任何元素
+        template<typename Iter>
+        static pointer copy_or_rollback(Iter bg, Iter ed, pointer dest){
+            return copy_or_rollback_imple(bg, ed, dest,
+                        typename GHYSTL::type_traits<value_type>::has_trivial_copy_constructor());
+        }
+
+        // 平凡复制不会抛异常
+        template<typename Iter>
+        static pointer copy_or_rollback_imple(Iter bg, Iter ed, pointer dest, GHYSTL::true_type){
+            return alloc::copy_construct(bg, ed, dest);
+        }
+
+        template<typename Iter>
+        static pointer copy_or_rollback_imple(Iter bg, Iter ed, pointer dest, GHYSTL::false_type){
+            pointer cur = dest;
+            try{
+                for(; bg != ed; ++bg, ++cur)
+                    alloc::construct(cur, *bg);
+            }
+            catch(...){
+                alloc::destroy(dest, cur);
+                throw;
+            }
+            return cur;
+        }
+
+        // 元素已经搬走，释放旧空间，换上新空间
+        void replace_storage(pointer new_first, pointer new_last, const size_type n){
+            this->get_alloc().deallocate(first, capacity());
+
+            first = new_first;
+            last = new_last;
+            end_storage = first + n;
+        }
+
         void deallocate_and_update_ptr(pointer new_first, pointer new_last, const size_type n){
             alloc::destroy(first, last);
-            alloc::deallocate(first, capacity());
+            this->get_alloc().deallocate(first, capacity());
 
             first = new_first;
             last = new_last;
@@ -569,8 +864,8 @@ namespace GHYSTL{
         }
     };
 
-    template<class T, class Alloc>
-    typename vector<T, Alloc>::self& vector<T, Alloc>::operator=(const self& rhs){
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::self& vector<T, Alloc, Growth>::operator=(const self& rhs){
         if (this != &rhs){
             const auto len = rhs.size();
             if (len > capacity()){ 
@@ -591,46 +886,67 @@ namespace GHYSTL{
         return *this;
     }
 
-    template<class T, class Alloc>
-    typename vector<T, Alloc>::self& vector<T, Alloc>::operator=(self&& x){
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::self& vector<T, Alloc, Growth>::operator=(self&& x){
         deallocate_and_update_ptr(x.first, x.last, x.capacity());
+        this->get_alloc() = x.get_alloc(); // 接管了 x 的空间，也要接管分配这块空间的分配器
         x.first = nullptr;
         x.last = nullptr;
         x.end_storage = nullptr;
         return *this;
     }
 
-    template<class T, class Alloc>
-    typename vector<T, Alloc>::iterator vector<T, Alloc>::insert(iterator pos, const size_t n, const T& x){
+    template<class T, class Alloc, class Growth>
+    typename vector<T, Alloc, Growth>::iterator vector<T, Alloc, Growth>::insert(iterator pos, const size_t n, const T& x){
         if(!n) return pos; // n == 0
 
         difference_type off = pos - begin();
         
         if(static_cast<size_t>(end_storage - last) >= n){
-            const size_type after_ele = end() - pos;
-            if(n < after_ele){
-                alloc::copy_construct(end()- n, end(), last);
-                GHYSTL::copy_backward(pos, end() - n, last);
-                GHYSTL::fill_n(pos, n, x);
+            // x 可能引用容器里的元素，后移之前先复制一份
+            const value_type val(x);
+            pointer p = first + off;
+            pointer old_last = last;
+            const size_type after_ele = old_last - p;
+            // 和 insert_in_place 一样，每构造好一个元素 last 才后移一位
+            if(n <= after_ele){
+                open_gap(p, n);
+                GHYSTL::fill(p, p + n, val);
             }else{
-                alloc::copy_consruct(end(), n - after_ele, x);
-                alloc::copy_consruct(pos, end(), last + (n - after_ele));
-                GHYSTL::fill_n(pos, n, x);
+                for(size_type i = after_ele; i != n; ++i){
+                    alloc::construct(last, val);
+                    ++last;
+                }
+                for(pointer src = p; src != old_last; ++src){
+                    alloc::construct(last, std::move(*src));
+                    ++last;
+                }
+                GHYSTL::fill(p, old_last, val);
             }
-            last += n;
         }else{
-            const size_type old_size = capacity();
-            const size_type len = old_size + (old_size > n ? old_size : n);
-            auto ptr = alloc::allocate(len);
-            pointer new_last = alloc::copy_construct(first, pos, ptr);
-            new_last = alloc::copy_construct(new_last, n, x);
-            new_last = alloc::copy_cosntruct(first + off, end(), new_last);
-            deallocate_and_update_ptr(ptr, new_last, len);
+            const size_type len = grow_capacity(size() + n);
+            pointer ptr = this->get_alloc().allocate(len);
+            pointer cur = ptr + off;
+            try{
+                // 先在新空间里构造插入的元素，失败时析构已经构造的，旧空间原封不动
+                for(; cur != ptr + off + n; ++cur)
+                    alloc::construct(cur, x);
+            }
+            catch(...){
+                alloc::destroy(ptr + off, cur);
+                this->get_alloc().deallocate(ptr, len);
+                throw;
+            }
+            relocate_around(ptr, off, n, len);
         }
         
         return (begin() + off);
     }
     
+    // vector 只有三个指针和分配器，按字节搬到新地址仍然有效，vector<vector<T>> 扩容时整块搬动
+    template<typename T, typename Alloc, typename Growth>
+    struct is_trivially_relocatable<vector<T, Alloc, Growth>> : bool_type<std::is_trivially_copyable<Alloc>::value> {};
+
     template<typename value_type, typename alloc>
     inline void swap(GHYSTL::vector<value_type>& left, GHYSTL::vector<value_type>& right) noexcept {
         left.swap(right);
@@ -82,6 +82,7 @@ struct char_traits
 
 // 特化 char_traits<char>
 // 使用了 标准函数
+// 空字符串的 buffer 是 nullptr，mem 系列函数不接受空指针，n 为 0 时直接返回
 template <> 
 struct char_traits<char>
 {
@@ -91,27 +92,30 @@ struct char_traits<char>
   { return std::strlen(str); }
 
   static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
-  { return std::memcmp(s1, s2, n); }
+  { return n == 0 ? 0 : std::memcmp(s1, s2, n); }
 
   static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
   {
     GHYSTL_DEBUG(src + n <= dst || dst + n <= src);
+    if (n == 0) return dst;
     return static_cast<char_type*>(std::memcpy(dst, src, n));
   }
 
   static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
   {
+    if (n == 0) return dst;
     return static_cast<char_type*>(std::memmove(dst, src, n));
   }
 
   static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept
   { 
+    if (count == 0) return dst;
     return static_cast<char_type*>(std::memset(dst, ch, count));
   }
 };
 
 // 特化. char_traits<wchar_t>
-// 使用了标准函数
+// 使用了标准函数，n 为 0 时同样直接返回
 template <>
 struct char_traits<wchar_t>
 {
@@ -124,22 +128,25 @@ struct char_traits<wchar_t>
 
   static int compare(const char_type* s1, const char_type* s2, size_t n) noexcept
   {
-    return std::wmemcmp(s1, s2, n);
+    return n == 0 ? 0 : std::wmemcmp(s1, s2, n);
   }
 
   static char_type* copy(char_type* dst, const char_type* src, size_t n) noexcept
   {
     GHYSTL_DEBUG(src + n <= dst || dst + n <= src);
+    if (n == 0) return dst;
     return static_cast<char_type*>(std::wmemcpy(dst, src, n));
   }
 
   static char_type* move(char_type* dst, const char_type* src, size_t n) noexcept
   {
+    if (n == 0) return dst;
     return static_cast<char_type*>(std::wmemmove(dst, src, n));
   }
 
   static char_type* fill(char_type* dst, char_type ch, size_t count) noexcept
   { 
+    if (count == 0) return dst;
     return static_cast<char_type*>(std::wmemset(dst, ch, count));
   }
 };
@@ -270,14 +277,19 @@ struct char_traits<char32_t>
 
 /************************************************** string 类 ***********************************************************/
 
-template<class CharType, class CharTraits = GHYSTL::char_traits<CharType>>
-class base_string{
+// Growth 是扩容策略，决定空间不够时新的容量，默认每次增加一半，见 allocator.h 里的 growth_half 等
+template<class CharType, class CharTraits = GHYSTL::char_traits<CharType>, class Alloc = GHYSTL::allocator<CharType>,
+         class Growth = GHYSTL::growth_half>
+class base_string : private GHYSTL::alloc_holder<Alloc>
+{
 public:
     typedef CharTraits                                  traits_type;
     typedef CharTraits                                  char_traits;
 
-    typedef GHYSTL::allocator<CharType>                 allocator_type;
-    typedef GHYSTL::allocator<CharType>                 data_allocator;
+    typedef Alloc                                       allocator_type;
+    typedef Growth                                      growth_policy;
+    typedef Alloc                                       data_allocator;
+    typedef GHYSTL::alloc_holder<Alloc>                 holder_type;
 
     typedef typename allocator_type::value_type         value_type;
     typedef typename allocator_type::pointer            pointer;
@@ -292,9 +304,9 @@ public:
     typedef GHYSTL::reverse_iterator<iterator>          reverse_iterator;
     typedef GHYSTL::reverse_iterator<const_iterator>    const_reverse_iterator;
 
-    allocator_type get_allocator() { return allocator_type(); }
+    allocator_type get_allocator() const { return this->get_alloc(); }
     
-    // 初始化 basi_string 尝试分配的最小 buffer 大小，可能被忽略
+    // 空字符串第一次分配 buffer 时的最小大小
     // 可能是因为我电脑的内存问题,设置 32 会一直出问题 
     size_type STRING_INIT_SIZE = 35;
 
@@ -309,14 +321,21 @@ public:
     static constexpr size_type npos = static_cast<size_type>(-1);
 
 private:
-  iterator  buffer_;  // 储存字符串的起始位置
+  iterator  buffer_;  // 储存字符串的起始位置，空字符串可以是 nullptr，第一次插入时才分配
   size_type size_;    // 大小
   size_type cap_;     // 容量
 
 public:
   /*-------------------------------------- 构造、复制、移动、析构函数 -----------------------------------------------*/
 
-    base_string() noexcept { try_init(); } // 默认构造函数
+    base_string() noexcept { try_init(); } // 默认构造函数，不分配 buffer
+
+    // 使用指定的分配器实例，字符串的 buffer 都从这个实例上分配
+    explicit base_string(const allocator_type& a) noexcept : holder_type(a) { try_init(); }
+
+    base_string(const_pointer str, const allocator_type& a) : holder_type(a), buffer_(nullptr), size_(0), cap_(0) {
+        init_from(str, 0, char_traits::length(str));
+    }
 
     // 用 ch 字符填充字符串
     base_string(size_type n, value_type ch) : buffer_(nullptr), size_(0), cap_(0) {
@@ -347,11 +366,11 @@ public:
         copy_init(first, last, GHYSTL::iterator_category(first)); 
     }
 
-    base_string(const base_string& rhs) : buffer_(nullptr), size_(0), cap_(0){
+    base_string(const base_string& rhs) : holder_type(rhs.get_alloc()), buffer_(nullptr), size_(0), cap_(0){
         init_from(rhs.buffer_, 0, rhs.size_);
     }
 
-    base_string(base_string&& rhs) noexcept : buffer_(rhs.buffer_), size_(rhs.size_), cap_(rhs.cap_) {
+    base_string(base_string&& rhs) noexcept : holder_type(rhs.get_alloc()), buffer_(rhs.buffer_), size_(rhs.size_), cap_(rhs.cap_) {
         rhs.buffer_ = nullptr;
         rhs.size_ = 0;
         rhs.cap_ = 0;
@@ -403,6 +422,8 @@ public:
 /*--------------------------------------------- 访问元素相关操作 (重写了运算符) -----------------------------------*/
     reference operator[](size_type n) {
         GHYSTL_DEBUG(n <= size_);
+        if (buffer_ == nullptr) // 返回的引用可以写，不能给共用的结束符，先分配自己的 buffer
+            reallocate(0);
         if (n == size_)
             *(buffer_ + n) = value_type();
         return *(buffer_ + n); 
@@ -410,6 +431,8 @@ public:
 
     const_reference operator[](size_type n) const{ 
         GHYSTL_DEBUG(n <= size_);
+        if (buffer_ == nullptr)
+            return *null_terminator();
         if (n == size_)
             *(buffer_ + n) = value_type();
         return *(buffer_ + n);
@@ -666,6 +689,12 @@ private:
 // get raw pointer
     const_pointer to_raw_pointer() const;
 
+    // 还没有 buffer 时 c_str()、data() 和 const 的 operator[](size()) 返回它，只读
+    static const_pointer null_terminator() noexcept {
+        static const value_type nul = value_type();
+        return &nul;
+    }
+
 // shrink_to_fit
     void reinsert(size_type size);
 
@@ -685,8 +714,23 @@ private:
     base_string& replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2);
 
 // reallocate
+    void resize_buffer(size_type new_cap);
+
+    void resize_buffer_imple(size_type new_cap, GHYSTL::true_type);
+
+    void resize_buffer_imple(size_type new_cap, GHYSTL::false_type);
+
     void reallocate(size_type need);
 
+    // 至少要有 n 的容量时，按扩容策略算出新的容量
+    size_type grow_capacity(size_type n) const { return Growth::new_capacity(this->get_alloc(), cap_, n); }
+
+    // 还要放下 need 个字符时的新容量，还没有 buffer 时至少是 STRING_INIT_SIZE
+    size_type next_capacity(size_type need) const {
+        return buffer_ == nullptr ? grow_capacity(GHYSTL::max(STRING_INIT_SIZE, need + 1))
+                                  : grow_capacity(cap_ + need);
+    }
+
     iterator reallocate_and_fill(iterator pos, size_type n, value_type ch);
 
     iterator reallocate_and_copy(iterator pos, const_iterator first, const_iterator last);
@@ -695,9 +739,9 @@ private:
 /****************************************** 方法的实现  ***********************************************/
 
 // 复制赋值操作符
-    template<class CharType, class CharTraits>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     operator=(const base_string& rhs){
         if(this != &rhs){
             base_string tmp(rhs);
@@ -707,11 +751,12 @@ private:
     }
     
 // 移动赋值操作符
-    template<class CharType, class CharTraits>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     operator=(base_string&& rhs) noexcept {
         destroy_buffer();
+        this->get_alloc() = rhs.get_alloc(); // 接管 rhs 的 buffer，也要接管分配它的分配器
         buffer_ = rhs.buffer_;
         size_ = rhs.size_;
         cap_ = rhs.cap_;
@@ -722,15 +767,15 @@ private:
     }
 
 // 用一个字符串赋值
-    template<class CharType, class CharTraits>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     operator=(const_pointer str){
         const size_type len = char_traits::length(str);
 
         if(cap_ < len){
-            auto new_buffer = data_allocator::allocate(len + 1);
-            data_allocator::deallocate(buffer_);
+            auto new_buffer = this->get_alloc().allocate(len + 1);
+            this->get_alloc().deallocate(buffer_);
             buffer_ = new_buffer;
             cap_ = len + 1;
         }
@@ -741,13 +786,13 @@ private:
     }
 
 // 用一个字符赋值
-    template<class CharType, class CharTraits>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     operator=(value_type ch){
         if(cap_ < 1){
-            auto new_buffer = data_allocator::allocate(2);
-            data_allocator::deallocate(buffer_);
+            auto new_buffer = this->get_alloc().allocate(2);
+            this->get_alloc().deallocate(buffer_);
             buffer_ = new_buffer;
             cap_ = 2;
         }
@@ -758,35 +803,32 @@ private:
     }
 
 // 预留储存空间, 增加容量
-    template<class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     reserve(size_type n) {
         if(cap_ < n){
             THROW_LENGTH_ERROR_IF(n > max_size(), "n can not larger than max_size()"
                           "in base_string<Char,Traits>::reserve(n)");
-            auto new_buffer = data_allocator::allocate(n);
-            char_traits::move(new_buffer, buffer_, size_);
-            buffer_ = new_buffer;
-            cap_ = n;
+            resize_buffer(n);
         }
     }
 
 // 减少不用的空间
-    template<class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     shrink_to_fit(){
         if(size_ != cap_)
             reinsert(size_);
     }
 
 //在 pos 处插入一个元素
-    template<class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     insert(const_iterator pos, value_type ch){
         iterator r = const_cast<iterator>(pos);
         if(size_ == cap_)
-            reallocate_and_fill(r, 1, ch);
+            return reallocate_and_fill(r, 1, ch); // 扩容时已经把 ch 填进去了，r 也已经失效
         char_traits::move(r + 1, r, end() - r);
         ++size_;
         *r = ch;
@@ -794,9 +836,9 @@ private:
     }
 
 // 在 pos 处插入 n 个元素
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     insert(const_iterator pos, size_type count, value_type ch){
         iterator r = const_cast<iterator>(pos);
         if (count == 0)
@@ -818,10 +860,10 @@ private:
     }
 
 // 在 pos 处插入 [first, last) 内的元素
-    template <class CharType, class CharTraits>
+    template <class CharType, class CharTraits, class Alloc, class Growth>
     template <class Iter>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     insert(const_iterator pos, Iter first, Iter last){
         iterator r = const_cast<iterator>(pos);
         const size_type len = GHYSTL::distance(first, last);
@@ -845,9 +887,9 @@ private:
     }
 
 // 在末尾添加 count 个 ch
-    template <class CharType, class CharTraits>
-    base_string<CharType, CharTraits>& 
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>& 
+    base_string<CharType, CharTraits, Alloc, Growth>::
     append(size_type count, value_type ch){
         THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                             "base_string<Char, Tratis>'s size too big");
@@ -860,9 +902,9 @@ private:
     }
 
 // 在末尾添加 [str[pos] str[pos+count]) 一段
-    template <class CharType, class CharTraits>
-    base_string<CharType, CharTraits>& 
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>& 
+    base_string<CharType, CharTraits, Alloc, Growth>::
     append(const base_string& str, size_type pos, size_type count) {
         THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                             "base_string<Char, Tratis>'s size too big"); 
@@ -878,9 +920,9 @@ private:
     }
 
 // 在末尾添加 [s, s+count) 一段
-    template <class CharType, class CharTraits>
-    base_string<CharType, CharTraits>& 
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>& 
+    base_string<CharType, CharTraits, Alloc, Growth>::
     append(const_pointer s, size_type count) {
         THROW_LENGTH_ERROR_IF(size_ > max_size() - count,
                                 "base_string<Char, Tratis>'s size too big");
@@ -893,9 +935,9 @@ private:
     }
 
 // 删除 pos 处的元素
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     erase(const_iterator pos) {
         GHYSTL_DEBUG(pos != end());
 
@@ -906,9 +948,9 @@ private:
     }
 
 // 删除 [first, last) 的元素
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     erase(const_iterator first, const_iterator last) {
         if (first == begin() && last == end()) {
             clear();
@@ -923,8 +965,8 @@ private:
     }
 
 // 重置容器大小
-    template <class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     resize(size_type count, value_type ch) {
         if (count < size_)
             erase(buffer_ + count, buffer_ + size_); // 比原来小，直接删除多余得
@@ -933,23 +975,23 @@ private:
     }
 
 // 比较两个 base_string，小于返回 -1，大于返回 1，等于返回 0
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare(const base_string& other) const {
         return compare_cstr(buffer_, size_, other.buffer_, other.size_);
     }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 base_string 比较
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare(size_type pos1, size_type count1, const base_string& other) const {
         auto n1 = GHYSTL::min(count1, size_ - pos1);
         return compare_cstr(buffer_ + pos1, n1, other.buffer_, other.size_);
     }
 
 // 从 pos1 下标开始的 count1 个字符跟另一个 base_string 下标 pos2 开始的 count2 个字符比较
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare(size_type pos1, size_type count1, 
             const base_string& other, size_type pos2, size_type count2) const
     {
@@ -959,16 +1001,16 @@ private:
     }
 
 // 跟一个字符串比较
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare(const_pointer s) const {
         auto n2 = char_traits::length(s);
         return compare_cstr(buffer_, size_, s, n2);
     }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串比较
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare(size_type pos1, size_type count1, const_pointer s) const {
         auto n1 = GHYSTL::min(count1, size_ - pos1);
         auto n2 = char_traits::length(s);
@@ -976,8 +1018,8 @@ private:
     }
 
 // 从下标 pos1 开始的 count1 个字符跟另一个字符串的前 count2 个字符比较
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare(size_type pos1, size_type count1, const_pointer s, size_type count2) const
     {
         auto n1 = GHYSTL::min(count1, size_ - pos1);
@@ -985,8 +1027,8 @@ private:
     }
 
 // 反转 base_string
-    template<class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     reverse() noexcept {
         // 双指针，一个在前，一个在后，两个不相交的时候， 就交换
         for(auto i = begin(), j = end(); i < j; )
@@ -994,20 +1036,21 @@ private:
     }
 
 // 交换两个 base_string
-    template <class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     swap(base_string& rhs) noexcept {
         if (this != &rhs) {
             GHYSTL::swap(buffer_, rhs.buffer_);
             GHYSTL::swap(size_, rhs.size_);
             GHYSTL::swap(cap_, rhs.cap_);
+            this->swap_alloc(rhs);
         }
     }
 
 // 从下标 pos 开始查找字符为 ch 的元素，若找到返回其下标，否则返回 npos
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find(value_type ch, size_type pos) const noexcept {
         for (auto i = pos; i < size_; ++i) {
             if (*(buffer_ + i) == ch)
@@ -1018,9 +1061,9 @@ private:
     }
 
 // 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-    template<class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find(const_pointer str, size_type pos) const noexcept { // 指针类型
         const auto len = char_traits::length(str);
 
@@ -1049,9 +1092,9 @@ private:
 
 
 // 从下标 pos 开始查找字符串 str 的前 count 个字符，若找到返回起始位置的下标，否则返回 npos
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find(const_pointer str, size_type pos, size_type count) const noexcept
     {
         if (count == 0)
@@ -1079,9 +1122,9 @@ private:
     }
 
 // 从下标 pos 开始查找字符串 str，若找到返回起始位置的下标，否则返回 npos
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find(const base_string& str, size_type pos) const noexcept // string类型
     {
         const size_type count = str.size_;
@@ -1110,9 +1153,9 @@ private:
     }
 
 // 从下标 pos 开始反向查找值为 ch 的元素，与 find 类似
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     rfind(value_type ch, size_type pos) const noexcept
     {
         if (pos >= size_)
@@ -1129,9 +1172,9 @@ private:
     }
 
 // 从下标 pos 开始反向查找字符串 str，与 find 类似
-    template<class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     rfind(const_pointer str, size_type pos) const noexcept {
         if(pos >= size_)
             pos = size_ - 1;
@@ -1172,9 +1215,9 @@ private:
     }
 
 // 从下标 pos 开始反向查找字符串 str 前 count 个字符，与 find 类似
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     rfind(const_pointer str, size_type pos, size_type count) const noexcept
     {
         if (count == 0)
@@ -1205,9 +1248,9 @@ private:
     }
 
 // 从下标 pos 开始反向查找字符串 str，与 find 类似
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     rfind(const base_string& str, size_type pos) const noexcept // 前面是指针类型，这个是 string 类型
     {
         const size_type count = str.size_;
@@ -1238,9 +1281,9 @@ private:
     }
 
 // 从下标 pos 开始查找 ch 出现的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_of(value_type ch, size_type pos) const noexcept
     {
         for (auto i = pos; i < size_; ++i)
@@ -1252,9 +1295,9 @@ private:
     }
 
 // 从下标 pos 开始查找字符串 s 其中的一个字符出现的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_of(const_pointer s, size_type pos) const noexcept
     {
         const size_type len = char_traits::length(s);
@@ -1272,9 +1315,9 @@ private:
     }
 
 // 从下标 pos 开始查找字符串 s 到 s + count  中的一个字符出现的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_of(const_pointer s, size_type pos, size_type count) const noexcept
     {
         for (auto i = pos; i < size_; ++i)
@@ -1290,9 +1333,9 @@ private:
     }
 
 // 从下标 pos 开始查找字符串 str 其中一个字符出现的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_of(const base_string& str, size_type pos) const noexcept
     {
         for (auto i = pos; i < size_; ++i)
@@ -1308,9 +1351,9 @@ private:
     }
 
 // 从下标 pos 开始查找与 ch 不相等的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_not_of(value_type ch, size_type pos) const noexcept
     {
         for (auto i = pos; i < size_; ++i)
@@ -1322,9 +1365,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 s 其中一个字符不相等的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_not_of(const_pointer s, size_type pos) const noexcept
     {
         const size_type len = char_traits::length(s);
@@ -1342,9 +1385,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_not_of(const_pointer s, size_type pos, size_type count) const noexcept
     {
         for (auto i = pos; i < size_; ++i)
@@ -1360,9 +1403,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 str 的字符中不相等的第一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_first_not_of(const base_string& str, size_type pos) const noexcept
     {
         for (auto i = pos; i < size_; ++i)
@@ -1378,9 +1421,9 @@ private:
     }
 
 // 从下标 pos 开始查找与 ch 相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_of(value_type ch, size_type pos) const noexcept
     {
         for (auto i = size_ - 1; i >= pos; --i)
@@ -1392,9 +1435,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 s 其中一个字符相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_of(const_pointer s, size_type pos) const noexcept
     {
         const size_type len = char_traits::length(s);
@@ -1411,9 +1454,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 s 前 count 个字符中相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_of(const_pointer s, size_type pos, size_type count) const noexcept
     {
         for (auto i = size_ - 1; i >= pos; --i)
@@ -1429,9 +1472,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 str 字符中相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_of(const base_string& str, size_type pos) const noexcept
     {
         for (auto i = size_ - 1; i >= pos; --i)
@@ -1447,9 +1490,9 @@ private:
     }
 
 // 从下标 pos 开始查找与 ch 字符不相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_not_of(value_type ch, size_type pos) const noexcept
     {
         for (auto i = size_ - 1; i >= pos; --i)
@@ -1461,9 +1504,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 s 的字符中不相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_not_of(const_pointer s, size_type pos) const noexcept
     {
         const size_type len = char_traits::length(s);
@@ -1480,9 +1523,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 s 前 count 个字符中不相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_not_of(const_pointer s, size_type pos, size_type count) const noexcept
     {
         for (auto i = size_ - 1; i >= pos; --i)
@@ -1498,9 +1541,9 @@ private:
     }
 
 // 从下标 pos 开始查找与字符串 str 字符中不相等的最后一个位置
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     find_last_not_of(const base_string& str, size_type pos) const noexcept
     {
         for (auto i = size_ - 1; i >= pos; --i)
@@ -1516,9 +1559,9 @@ private:
     }
 
 // 返回从下标 pos 开始字符为 ch 的元素出现的次数
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::size_type
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::size_type
+    base_string<CharType, CharTraits, Alloc, Growth>::
     count(value_type ch, size_type pos) const noexcept
     {
         size_type n = 0;
@@ -1532,44 +1575,36 @@ private:
 
 /************************************************* 底层操作实现 *******************************************************/
 
-// 尝试初始化一段 buffer，若分配失败则忽略，不会抛出异常
-    template<class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+// 空字符串不分配 buffer，第一次插入时由 reallocate 分配，不会抛出异常
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     try_init() noexcept {
-        try{
-            buffer_ = data_allocator::allocate(STRING_INIT_SIZE);
-            size_ = 0;
-            cap_ = 0;
-        }
-        catch(...){
-            buffer_ = nullptr;
-            size_ = 0;
-            cap_ = 0;
-            // 不抛异常
-        }
+        buffer_ = nullptr;
+        size_ = 0;
+        cap_ = 0;
     }
 
 // fill_init 函数
-    template<class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     fill_init(size_type n, value_type ch){
         size_t init_size = GHYSTL::max(STRING_INIT_SIZE, n + 1);
-        buffer_ = data_allocator::allocate(init_size);
+        buffer_ = this->get_alloc().allocate(init_size);
         char_traits::fill(buffer_, ch, n);
         size_ = n;
         cap_ = init_size;
     }
 
 // copy_init 函数
-    template<class CharType, class CharTraits>
+    template<class CharType, class CharTraits, class Alloc, class Growth>
     template<class Iter>
-    void base_string<CharType, CharTraits>::
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     copy_init(Iter first, Iter last, GHYSTL::input_iterator_tag){
         size_type n = GHYSTL::distance(first, last);
         size_t init_size = GHYSTL::max(STRING_INIT_SIZE, n + 1);
 
         try{
-            buffer_ = data_allocator::allocate(init_size);
+            buffer_ = this->get_alloc().allocate(init_size);
             size_ = n;
             cap_ = init_size;
         }
@@ -1584,15 +1619,15 @@ private:
             append(first);
     }
 
-    template<class CharType, class CharTraits>
+    template<class CharType, class CharTraits, class Alloc, class Growth>
     template<class Iter>
-    void base_string<CharType, CharTraits>::
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     copy_init(Iter first, Iter last, GHYSTL::forward_iterator_tag){
         size_type n = GHYSTL::distance(first, last);
         size_t init_size = GHYSTL::max(STRING_INIT_SIZE, n + 1);
 
         try{
-            buffer_ = data_allocator::allocate(init_size);
+            buffer_ = this->get_alloc().allocate(init_size);
             size_ = n;
             cap_ = init_size;
             char_traits::copy(buffer_, first, n);
@@ -1606,25 +1641,27 @@ private:
     }
 
 // init_from 函数
-    template <class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     init_from(const_pointer src, size_type pos, size_type count)
     {
+        if (count == 0) // 空串不分配
+            return try_init();
         size_t init_size = GHYSTL::max(count + 1, STRING_INIT_SIZE);
-        buffer_ = data_allocator::allocate(init_size);
+        buffer_ = this->get_alloc().allocate(init_size);
         char_traits::copy(buffer_, src + pos, count);
         size_ = count;
         cap_ = init_size;
     }
 
 // destroy_buffer 函数
-    template <class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     destroy_buffer()
     {
         if (buffer_ != nullptr)
         {
-            data_allocator::deallocate(buffer_, cap_);
+            this->get_alloc().deallocate(buffer_, cap_);
             buffer_ = nullptr;
             size_ = 0;
             cap_ = 0;
@@ -1632,39 +1669,31 @@ private:
     }
 
 // to_raw_pointer 函数
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::const_pointer
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::const_pointer
+    base_string<CharType, CharTraits, Alloc, Growth>::
     to_raw_pointer() const
     {
+        if (buffer_ == nullptr)
+            return null_terminator();
         *(buffer_ + size_) = value_type(); // size 上的空间初始化成字符
         return buffer_;
     }
 
 // reinsert 函数
-    template <class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
     reinsert(size_type size)
     {
-        auto new_buffer = data_allocator::allocate(size);
-
-        try{
-            char_traits::move(new_buffer, buffer_, size);
-        }
-        catch (...){
-            data_allocator::deallocate(new_buffer);
-        }
-
-        buffer_ = new_buffer;
+        resize_buffer(size);
         size_ = size;
-        cap_ = size;
     }
 
 // append_range，末尾追加一段 [first, last) 内的字符
-    template<class CharType, class CharTraits>
+    template<class CharType, class CharTraits, class Alloc, class Growth>
     template<class Iter>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     append_range(Iter first, Iter last){
         const size_type n = GHYSTL::distance(first, last);
         THROW_LENGTH_ERROR_IF(size_ > max_size() - n,
@@ -1678,8 +1707,8 @@ private:
     }
 
 // 比较字符串
-    template <class CharType, class CharTraits>
-    int base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    int base_string<CharType, CharTraits, Alloc, Growth>::
     compare_cstr(const_pointer s1, size_type n1, const_pointer s2, size_type n2) const
     {
         auto rlen = GHYSTL::min(n1, n2);
@@ -1691,9 +1720,9 @@ private:
     }
 
 // 把 first 开始的 count1 个字符替换成 str 开始的 count2 个字符
-    template <class CharType, class CharTraits>
-    base_string<CharType, CharTraits>& 
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>& 
+    base_string<CharType, CharTraits, Alloc, Growth>::
     replace_cstr(const_iterator first, size_type count1, const_pointer str, size_type count2)
     {
         if (static_cast<size_type>(cend() - first) < count1) {
@@ -1705,11 +1734,12 @@ private:
             THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                                 "base_string<Char, Traits>'s size too big");
 
+            const size_type off = first - cbegin(); // 扩容后 first 失效，按下标重新定位
             if (add > cap_ - size_)
                 reallocate(add);
             
-            pointer r = const_cast<pointer>(first);
-            char_traits::move(r + count2, first + count1, end() - (first + count1)); // 把 count1 的数据向后移动
+            pointer r = buffer_ + off;
+            char_traits::move(r + count2, r + count1, end() - (r + count1)); // 把 count1 的数据向后移动
             char_traits::copy(r, str, count2);// 把 str2 的数据放到本字符串中
             size_ += add;
         }
@@ -1724,9 +1754,9 @@ private:
     }
 
 // 把 first 开始的 count1 个字符替换成 count2 个 ch 字符
-    template <class CharType, class CharTraits>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     replace_fill(const_iterator first, size_type count1, size_type count2, value_type ch)
     {
         if (static_cast<size_type>(cend() - first) < count1)
@@ -1737,11 +1767,12 @@ private:
             const size_type add = count2 - count1;
             THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                                 "base_string<Char, Traits>'s size too big");
+            const size_type off = first - cbegin(); // 扩容后 first 失效，按下标重新定位
             if (add > cap_ - size_)
                 reallocate(add);
             
-            pointer r = const_cast<pointer>(first);
-            char_traits::move(r + count2, first + count1, end() - (first + count1));
+            pointer r = buffer_ + off;
+            char_traits::move(r + count2, r + count1, end() - (r + count1));
             char_traits::fill(r, ch, count2);
             size_ += add;
         }
@@ -1755,10 +1786,10 @@ private:
     }
 
 // 把 [first, last) 的字符替换成 [first2, last2)
-    template <class CharType, class CharTraits>
+    template <class CharType, class CharTraits, class Alloc, class Growth>
     template <class Iter>
-    base_string<CharType, CharTraits>&
-    base_string<CharType, CharTraits>::
+    base_string<CharType, CharTraits, Alloc, Growth>&
+    base_string<CharType, CharTraits, Alloc, Growth>::
     replace_copy(const_iterator first, const_iterator last, Iter first2, Iter last2)
     {
         size_type len1 = last - first;
@@ -1768,11 +1799,12 @@ private:
             const size_type add = len2 - len1;
             THROW_LENGTH_ERROR_IF(size_ > max_size() - add,
                                 "base_string<Char, Traits>'s size too big");
-            if (size_ > cap_ - add)
+            const size_type off = first - cbegin(); // 扩容后 first 失效，按下标重新定位
+            if (add > cap_ - size_)
                 reallocate(add);
 
-            pointer r = const_cast<pointer>(first);
-            char_traits::move(r + len2, first + len1, end() - (first + len1));
+            pointer r = buffer_ + off;
+            char_traits::move(r + len2, r + len1, end() - (r + len1));
             char_traits::copy(r, first2, len2);
             size_ += add;
         }
@@ -1786,31 +1818,56 @@ private:
         return *this;
     }
 
-// reallocate 函数
-    template<class CharType, class CharTraits>
-    void base_string<CharType, CharTraits>::
-    reallocate(size_type need){
-        const auto new_cap = GHYSTL::max(cap_ + need, cap_ + (cap_ >> 1));
-        auto new_buffer = data_allocator::allocate(new_cap);
-        char_traits::move(new_buffer, buffer_, size_);
+// resize_buffer 函数，把容量调整为 new_cap，保留原来的字符
+// 分配器提供 reallocate 时直接用它，大的 buffer 可以由 realloc 原地扩展，不用整块复制
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
+    resize_buffer(size_type new_cap){
+        resize_buffer_imple(new_cap, GHYSTL::bool_type<GHYSTL::has_reallocate<Alloc>::value>());
+    }
+
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
+    resize_buffer_imple(size_type new_cap, GHYSTL::true_type){
+        buffer_ = this->get_alloc().reallocate(buffer_, cap_, new_cap);
+        cap_ = new_cap;
+    }
+
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
+    resize_buffer_imple(size_type new_cap, GHYSTL::false_type){
+        auto new_buffer = this->get_alloc().allocate(new_cap);
+        if(buffer_ != nullptr){
+            char_traits::move(new_buffer, buffer_, GHYSTL::min(size_, new_cap));
+            this->get_alloc().deallocate(buffer_, cap_);
+        }
         buffer_ = new_buffer;
         cap_ = new_cap;
     }
 
+// reallocate 函数
+    template<class CharType, class CharTraits, class Alloc, class Growth>
+    void base_string<CharType, CharTraits, Alloc, Growth>::
+    reallocate(size_type need){
+        resize_buffer(next_capacity(need));
+    }
+
 // reallocate_and_fill 函数
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     reallocate_and_fill(iterator pos, size_type n, value_type ch)
     {
         const auto r = pos - buffer_;
         const auto old_cap = cap_;
-        const auto new_cap = GHYSTL::max(old_cap + n, old_cap + (old_cap >> 1));
-        auto new_buffer = data_allocator::allocate(new_cap);
-        auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
-        auto e2 = char_traits::fill(e1, ch, n) + n;
-        char_traits::move(e2, buffer_ + r, size_ - r);
-        data_allocator::deallocate(buffer_, old_cap);
+        const auto new_cap = next_capacity(n);
+        auto new_buffer = this->get_alloc().allocate(new_cap);
+        auto e2 = char_traits::fill(new_buffer + r, ch, n) + n;
+        if (buffer_ != nullptr){ // 原来的字符搬到插入点两边
+            char_traits::move(new_buffer, buffer_, r);
+            char_traits::move(e2, buffer_ + r, size_ - r);
+            this->get_alloc().deallocate(buffer_, old_cap);
+        }
         buffer_ = new_buffer;
         size_ += n;
         cap_ = new_cap;
@@ -1818,20 +1875,22 @@ private:
     }
 
 // reallocate_and_copy 函数
-    template <class CharType, class CharTraits>
-    typename base_string<CharType, CharTraits>::iterator
-    base_string<CharType, CharTraits>::
+    template <class CharType, class CharTraits, class Alloc, class Growth>
+    typename base_string<CharType, CharTraits, Alloc, Growth>::iterator
+    base_string<CharType, CharTraits, Alloc, Growth>::
     reallocate_and_copy(iterator pos, const_iterator first, const_iterator last)
     {
         const auto r = pos - buffer_;
         const auto old_cap = cap_;
         const size_type n = GHYSTL::distance(first, last);
-        const auto new_cap = GHYSTL::max(old_cap + n, old_cap + (old_cap >> 1));
-        auto new_buffer = data_allocator::allocate(new_cap);
-        auto e1 = char_traits::move(new_buffer, buffer_, r) + r;
-        auto e2 = char_traits::move(e1, first, n) + n;
-        char_traits::move(e2, buffer_ + r, size_ - r);
-        data_allocator::deallocate(buffer_, old_cap);
+        const auto new_cap = next_capacity(n);
+        auto new_buffer = this->get_alloc().allocate(new_cap);
+        auto e2 = char_traits::move(new_buffer + r, first, n) + n;
+        if (buffer_ != nullptr){ // 原来的字符搬到插入点两边
+            char_traits::move(new_buffer, buffer_, r);
+            char_traits::move(e2, buffer_ + r, size_ - r);
+            this->get_alloc().deallocate(buffer_, old_cap);
+        }
         buffer_ = new_buffer;
         size_ += n;
         cap_ = new_cap;
@@ -1840,165 +1899,170 @@ private:
 
 /*************************************** 重载全局操作符 **************************************************/
 // 重载 operator+
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(const base_string<CharType, CharTraits>& lhs, 
-          const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(const base_string<CharType, CharTraits, Alloc, Growth>& lhs, 
+          const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  base_string<CharType, CharTraits> tmp(lhs);
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(const CharType* lhs, const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(const CharType* lhs, const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  base_string<CharType, CharTraits> tmp(lhs);
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(CharType ch, const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(CharType ch, const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  base_string<CharType, CharTraits> tmp(1, ch);
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(1, ch);
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(const base_string<CharType, CharTraits>& lhs, const CharType* rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(const base_string<CharType, CharTraits, Alloc, Growth>& lhs, const CharType* rhs)
 {
-  base_string<CharType, CharTraits> tmp(lhs);
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(const base_string<CharType, CharTraits>& lhs, CharType ch)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(const base_string<CharType, CharTraits, Alloc, Growth>& lhs, CharType ch)
 {
-  base_string<CharType, CharTraits> tmp(lhs);
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(lhs);
   tmp.append(1, ch);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(base_string<CharType, CharTraits>&& lhs,
-          const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(base_string<CharType, CharTraits, Alloc, Growth>&& lhs,
+          const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
-  base_string<CharType, CharTraits> tmp(std::move(lhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(lhs));
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(const base_string<CharType, CharTraits>& lhs,
-          base_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+          base_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  base_string<CharType, CharTraits> tmp(std::move(rhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(rhs));
   tmp.insert(tmp.begin(), lhs.begin(), lhs.end());
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(base_string<CharType, CharTraits>&& lhs,
-          base_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(base_string<CharType, CharTraits, Alloc, Growth>&& lhs,
+          base_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  base_string<CharType, CharTraits> tmp(std::move(lhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(lhs));
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(const CharType* lhs, base_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(const CharType* lhs, base_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  base_string<CharType, CharTraits> tmp(std::move(rhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(rhs));
   tmp.insert(tmp.begin(), lhs, lhs + char_traits<CharType>::length(lhs));
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(CharType ch, base_string<CharType, CharTraits>&& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(CharType ch, base_string<CharType, CharTraits, Alloc, Growth>&& rhs)
 {
-  base_string<CharType, CharTraits> tmp(std::move(rhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(rhs));
   tmp.insert(tmp.begin(), ch);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(base_string<CharType, CharTraits>&& lhs, const CharType* rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(base_string<CharType, CharTraits, Alloc, Growth>&& lhs, const CharType* rhs)
 {
-  base_string<CharType, CharTraits> tmp(std::move(lhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(lhs));
   tmp.append(rhs);
   return tmp;
 }
 
-template <class CharType, class CharTraits>
-base_string<CharType, CharTraits>
-operator+(base_string<CharType, CharTraits>&& lhs, CharType ch)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+base_string<CharType, CharTraits, Alloc, Growth>
+operator+(base_string<CharType, CharTraits, Alloc, Growth>&& lhs, CharType ch)
 {
-  base_string<CharType, CharTraits> tmp(std::move(lhs));
+  base_string<CharType, CharTraits, Alloc, Growth> tmp(std::move(lhs));
   tmp.append(1, ch);
   return tmp;
 }
 
 // 重载比较操作符
-template <class CharType, class CharTraits>
-bool operator==(const base_string<CharType, CharTraits>& lhs,
-                const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator==(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.size() == rhs.size() && lhs.compare(rhs) == 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator!=(const base_string<CharType, CharTraits>& lhs,
-                const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator!=(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.size() != rhs.size() || lhs.compare(rhs) != 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator<(const base_string<CharType, CharTraits>& lhs,
-               const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator<(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+               const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) < 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator<=(const base_string<CharType, CharTraits>& lhs,
-                const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator<=(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) <= 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator>(const base_string<CharType, CharTraits>& lhs,
-               const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator>(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+               const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) > 0;
 }
 
-template <class CharType, class CharTraits>
-bool operator>=(const base_string<CharType, CharTraits>& lhs,
-                const base_string<CharType, CharTraits>& rhs)
+template <class CharType, class CharTraits, class Alloc, class Growth>
+bool operator>=(const base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+                const base_string<CharType, CharTraits, Alloc, Growth>& rhs)
 {
   return lhs.compare(rhs) >= 0;
 }
 
+// base_string 没有指向自身的指针，按字节搬到新地址仍然有效，vector<string> 扩容时整块搬动
+template <class CharType, class CharTraits, class Alloc, class Growth>
+struct is_trivially_relocatable<base_string<CharType, CharTraits, Alloc, Growth>>
+  : bool_type<std::is_trivially_copyable<Alloc>::value> {};
+
 // 重载 GHYSTL 的 swap
-template <class CharType, class CharTraits>
-void swap(base_string<CharType, CharTraits>& lhs,
-          base_string<CharType, CharTraits>& rhs) noexcept
+template <class CharType, class CharTraits, class Alloc, class Growth>
+void swap(base_string<CharType, CharTraits, Alloc, Growth>& lhs,
+          base_string<CharType, CharTraits, Alloc, Growth>& rhs) noexcept
 {
   lhs.swap(rhs);
 }
@@ -0,0 +1,77 @@
+#include <iostream>
+#include <chrono>
+#include <thread>
+#include <cstdlib>
+
+#include "../allocator/alloc.h"
+
+using namespace GHYSTL;
+
+// 多线程分配/释放的基准测试：二级配置器(线程缓存) 对比 glibc malloc
+// 每个线程反复申请一批 8~128 字节的小块，写入数据后再全部释放
+
+const size_t kRounds = 2000;
+const size_t kBatch = 512;
+
+struct pool_policy
+{
+	static void* allocate(size_t n) { return default_alloc::allocate(n); }
+	static void deallocate(void* p, size_t n) { default_alloc::deallocate(p, n); }
+};
+
+struct malloc_policy
+{
+	static void* allocate(size_t n) { return std::malloc(n); }
+	static void deallocate(void* p, size_t) { std::free(p); }
+};
+
+template<typename Policy>
+void worker(size_t seed, size_t& errors)
+{
+	void* ptrs[kBatch];
+	size_t sizes[kBatch];
+	for (size_t round = 0; round < kRounds; ++round) {
+		for (size_t i = 0; i < kBatch; ++i) {
+			sizes[i] = ((seed + i * 7 + round) % 16 + 1) * 8;
+			ptrs[i] = Policy::allocate(sizes[i]);
+			*static_cast<size_t*>(ptrs[i]) = seed + i;
+		}
+		for (size_t i = 0; i < kBatch; ++i) {
+			if (*static_cast<size_t*>(ptrs[i]) != seed + i) ++errors;
+			Policy::deallocate(ptrs[i], sizes[i]);
+		}
+	}
+}
+
+template<typename Policy>
+double run(size_t nthreads, size_t& errors)
+{
+	std::thread threads[64];
+	size_t err[64] = { 0 };
+	auto start = std::chrono::steady_clock::now();
+	for (size_t t = 0; t < nthreads; ++t)
+		threads[t] = std::thread(worker<Policy>, t * 1000, std::ref(err[t]));
+	for (size_t t = 0; t < nthreads; ++t)
+		threads[t].join();
+	auto end = std::chrono::steady_clock::now();
+	for (size_t t = 0; t < nthreads; ++t) errors += err[t];
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+	size_t errors = 0;
+	size_t max_threads = std::thread::hardware_concurrency();
+	if (max_threads == 0) max_threads = 4;
+	if (max_threads > 64) max_threads = 64;
+
+	std::cout << "threads\tdefault_alloc(ms)\tmalloc(ms)" << std::endl;
+	for (size_t n = 1; n <= max_threads; n *= 2) {
+		double pool = run<pool_policy>(n, errors);
+		double sys = run<malloc_policy>(n, errors);
+		std::cout << n << "\t" << pool << "\t\t\t" << sys << std::endl;
+	}
+
+	std::cout << "errors = " << errors << std::endl;
+	return errors == 0 ? 0 : 1;
+}
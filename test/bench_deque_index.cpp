@@ -0,0 +1,76 @@
+#include <iostream>
+#include <chrono>
+
+#include "../containers_seqence/deque.h"
+
+using namespace GHYSTL;
+
+// 缓冲区元素个数是不是 2 的幂对 deque 随机访问的影响
+//   int：1000(原来按 4096 / sizeof 算不是 2 的幂的情形) 对比默认的 1024
+//   12 字节的结构体：原来的默认值 341 对比现在的默认值 256
+// 分别测随机 operator[] 和对整个 deque 做 sort
+
+const size_t kElements = 4000000;
+const size_t kLookups = 20000000;
+
+struct point3
+{
+	int x, y, z;
+	bool operator<(const point3& rhs) const { return x < rhs.x; }
+};
+
+unsigned next_rand(unsigned& seed)
+{
+	seed = seed * 1103515245u + 12345u;
+	return seed >> 8;
+}
+
+int key_of(int v) { return v; }
+int key_of(const point3& p) { return p.x; }
+
+template<typename Func>
+double time_ms(Func f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template<typename Deque, typename Make>
+void run(const char* title, Make make)
+{
+	unsigned seed = 1;
+	Deque d;
+	for (size_t i = 0; i < kElements; ++i)
+		d.push_back(make(next_rand(seed)));
+
+	long long sum = 0;
+	const double lookup = time_ms([&] {
+		unsigned s = 2;
+		for (size_t i = 0; i < kLookups; ++i)
+			sum += key_of(d[next_rand(s) % kElements]);
+	});
+
+	const double sorting = time_ms([&] { GHYSTL::sort(d.begin(), d.end()); });
+
+	bool sorted = true;
+	for (size_t i = 1; i < kElements; ++i)
+		if (key_of(d[i]) < key_of(d[i - 1])) sorted = false;
+
+	std::cout << title << "\t" << Deque::buffer_size << "\t\t" << lookup << "\t\t" << sorting
+		<< "\t\t" << (sorted ? "有序" : "无序") << " " << sum % 10 << std::endl;
+}
+
+int main()
+{
+	std::cout << kElements << " 个元素，随机 operator[] " << kLookups << " 次，再 sort 一次" << std::endl;
+	std::cout << "元素\t缓冲区大小\t随机下标(ms)\tsort(ms)\t结果" << std::endl;
+	auto make_int = [](unsigned r) { return int(r); };
+	auto make_point = [](unsigned r) { return point3{ int(r), int(r >> 3), 0 }; };
+	run<deque<int, allocator<int>, 1000>>("int", make_int);
+	run<deque<int>>("int", make_int);
+	run<deque<point3, allocator<point3>, 341>>("point3", make_point);
+	run<deque<point3>>("point3", make_point);
+	return 0;
+}
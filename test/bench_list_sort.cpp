@@ -0,0 +1,48 @@
+#include <iostream>
+#include <chrono>
+#include <list>
+
+#include "../containers_seqence/list.h"
+
+// list::sort 在结点打乱在堆上的时候的耗时，和 std::list::sort 对比
+// 先用随机值排一次序，结点在链上的顺序就和地址顺序无关了，再换一批随机值计时排序
+// 少于 65536 个结点时在 next 指针上归并，更多时收集结点地址到数组里排序
+
+unsigned next_rand(unsigned& seed)
+{
+	seed = seed * 1103515245u + 12345u;
+	return seed >> 8;
+}
+
+template<typename List>
+double run(size_t n)
+{
+	unsigned seed = 42;
+	List l;
+	for (size_t i = 0; i < n; ++i)
+		l.push_back(int(next_rand(seed)));
+	l.sort();
+	for (auto it = l.begin(); it != l.end(); ++it)
+		*it = int(next_rand(seed));
+
+	auto start = std::chrono::steady_clock::now();
+	l.sort();
+	auto end = std::chrono::steady_clock::now();
+
+	for (auto it = l.begin(), prev = it++; it != l.end(); prev = it++) {
+		if (*it < *prev) {
+			std::cout << "排序结果错误" << std::endl;
+			break;
+		}
+	}
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+	std::cout << "结点数\tGHYSTL::list(ms)\tstd::list(ms)" << std::endl;
+	const size_t sizes[] = { 1000, 10000, 100000, 1000000, 4000000 };
+	for (size_t n : sizes)
+		std::cout << n << "\t" << run<GHYSTL::list<int>>(n) << "\t\t" << run<std::list<int>>(n) << std::endl;
+	return 0;
+}
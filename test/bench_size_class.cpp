@@ -0,0 +1,82 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+
+#include "../containers_associative/map.h"
+#include "../containers_associative/unordered_map.h"
+#include "../containers_seqence/vector.h"
+#include "../containers_string/string.h"
+
+using namespace GHYSTL;
+
+// 二级配置器大小类别的基准测试：map<string,string> 与 unordered_map<string, vector<int>> 的插入吞吐
+// 字符串长度和 vector 的容量都落在 128 字节 ~ 几 KB 之间
+// 对比时分别编译两次：
+//   默认（大小类别到 4096 字节）
+//   -DGHYSTL_ALLOC_MAX_BYTES=128（原来的 16 条自由链表，超过 128 字节都走 malloc）
+
+const size_t kElements = 50000;
+const size_t kRounds = 3;
+
+// FNV-1a，hash_string 只保留最后几十个字符的信息，长键会大量冲突
+struct string_hash
+{
+	size_t operator()(const string& s) const {
+		size_t h = 14695981039346656037ull;
+		for (size_t i = 0; i < s.size(); ++i) {
+			h ^= static_cast<unsigned char>(s[i]);
+			h *= 1099511628211ull;
+		}
+		return h;
+	}
+};
+
+string make_key(size_t i, size_t len)
+{
+	char buf[32];
+	std::snprintf(buf, sizeof(buf), "%08zu", i);
+	string s(buf);
+	while (s.size() < len) s.push_back(static_cast<char>('a' + (i + s.size()) % 26));
+	return s;
+}
+
+template<typename F>
+double measure(F f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+int main()
+{
+	size_t checksum = 0;
+
+	double map_ms = measure([&] {
+		for (size_t r = 0; r < kRounds; ++r) {
+			map<string, string> m;
+			for (size_t i = 0; i < kElements; ++i)
+				m.insert(pair<const string, string>(make_key(i, 24 + i % 200), make_key(i, 100 + i % 400)));
+			checksum += m.size();
+		}
+	});
+
+	double umap_ms = measure([&] {
+		for (size_t r = 0; r < kRounds; ++r) {
+			unordered_map<string, vector<int>, string_hash> m;
+			for (size_t i = 0; i < kElements; ++i) {
+				vector<int> v;
+				for (size_t k = 0; k < 16 + i % 256; ++k) v.push_back(static_cast<int>(k));
+				m.insert(pair<const string, vector<int>>(make_key(i, 24 + i % 200), v));
+			}
+			checksum += m.size();
+		}
+	});
+
+	std::cout << "_MAX_BYTES = " << _MAX_BYTES << ", 自由链表个数 = " << _NFREELIST << std::endl;
+	std::cout << "map<string,string> 插入 " << kRounds << " x " << kElements << ": " << map_ms << " ms" << std::endl;
+	std::cout << "unordered_map<string,vector<int>> 插入 " << kRounds << " x " << kElements << ": " << umap_ms << " ms" << std::endl;
+	std::cout << "checksum = " << checksum << std::endl;
+	return checksum == 2 * kRounds * kElements ? 0 : 1;
+}
@@ -0,0 +1,60 @@
+#include <iostream>
+#include <chrono>
+
+#include "../containers_seqence/vector.h"
+#include "../containers_seqence/soa_vector.h"
+
+using namespace GHYSTL;
+
+// 10M 行的记录只扫描价格一列：vector<record> 每读一个价格要把整条 64 字节的记录读进缓存，
+// soa_vector 的价格是一段连续的 double
+
+const size_t kRows = 10000000;
+const size_t kRounds = 5;
+
+struct record
+{
+	int id;
+	int flags;
+	double price;
+	double cost;
+	char note[40];
+};
+
+int main()
+{
+	vector<record> aos;
+	soa_vector<int, int, double, double> soa;
+	aos.reserve(kRows);
+	soa.reserve(kRows);
+	for (size_t i = 0; i < kRows; ++i) {
+		record r = { int(i), 0, double(i % 1000) * 0.5, 1.0, { 0 } };
+		aos.push_back(r);
+		soa.emplace_back(int(i), 0, double(i % 1000) * 0.5, 1.0);
+	}
+
+	double sum[2] = { 0, 0 };
+	double ms[2] = { 0, 0 };
+
+	auto start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < kRounds; ++r)
+		for (size_t i = 0; i < aos.size(); ++i)
+			sum[0] += aos[i].price;
+	auto end = std::chrono::steady_clock::now();
+	ms[0] = std::chrono::duration<double, std::milli>(end - start).count();
+
+	start = std::chrono::steady_clock::now();
+	for (size_t r = 0; r < kRounds; ++r) {
+		soa_span<double> price = soa.column<2>();
+		for (size_t i = 0; i < price.size(); ++i)
+			sum[1] += price[i];
+	}
+	end = std::chrono::steady_clock::now();
+	ms[1] = std::chrono::duration<double, std::milli>(end - start).count();
+
+	std::cout << kRows << " 行扫描价格一列 x " << kRounds << " 轮" << std::endl;
+	std::cout << "vector<record>(ms)\tsoa_vector(ms)" << std::endl;
+	std::cout << ms[0] << "\t\t\t" << ms[1] << std::endl;
+	std::cout << "结果一致: " << (sum[0] == sum[1]) << std::endl;
+	return 0;
+}
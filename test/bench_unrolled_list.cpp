@@ -0,0 +1,99 @@
+#include <iostream>
+#include <chrono>
+
+#include "../containers_seqence/vector.h"
+#include "../containers_seqence/list.h"
+#include "../containers_seqence/unrolled_list.h"
+
+using namespace GHYSTL;
+
+// 2M 个 int 的遍历求和：list 先排一次序把结点顺序打乱，一个元素一次缓存缺失；
+// unrolled_list 每个结点放 128 个 int，分别用迭代器和 for_each_segment 遍历
+
+const size_t kElements = 2000000;
+const int kRounds = 10;
+
+unsigned next_rand(unsigned& seed)
+{
+	seed = seed * 1103515245u + 12345u;
+	return seed >> 8;
+}
+
+template<typename Func>
+double time_ms(Func f)
+{
+	auto start = std::chrono::steady_clock::now();
+	f();
+	auto end = std::chrono::steady_clock::now();
+	return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template<typename Container>
+long long sum_by_iterator(const Container& c)
+{
+	long long sum = 0;
+	for (auto it = c.begin(); it != c.end(); ++it)
+		sum += *it;
+	return sum;
+}
+
+int main()
+{
+	unsigned seed = 7;
+	vector<int> v;
+	list<int> l;
+	unrolled_list<int> u;
+	for (size_t i = 0; i < kElements; ++i) {
+		const int x = int(next_rand(seed) % 1000);
+		v.push_back(x);
+		l.push_back(x);
+		u.push_back(x);
+	}
+	l.sort();
+
+	long long sums[4] = { 0, 0, 0, 0 };
+	double ms[4];
+	ms[0] = time_ms([&] { for (int r = 0; r < kRounds; ++r) sums[0] += sum_by_iterator(v); });
+	ms[1] = time_ms([&] { for (int r = 0; r < kRounds; ++r) sums[1] += sum_by_iterator(l); });
+	ms[2] = time_ms([&] { for (int r = 0; r < kRounds; ++r) sums[2] += sum_by_iterator(u); });
+	ms[3] = time_ms([&] {
+		for (int r = 0; r < kRounds; ++r)
+			u.for_each_segment([&](const int* first, const int* last) {
+				long long sum = 0;
+				for (; first != last; ++first) sum += *first;
+				sums[3] += sum;
+			});
+	});
+
+	std::cout << kElements << " 个 int 遍历 " << kRounds << " 次" << std::endl;
+	std::cout << "vector\t\t\t" << ms[0] << " ms" << std::endl;
+	std::cout << "list(结点打乱)\t\t" << ms[1] << " ms" << std::endl;
+	std::cout << "unrolled_list 迭代器\t" << ms[2] << " ms" << std::endl;
+	std::cout << "unrolled_list 按结点\t" << ms[3] << " ms" << std::endl;
+	std::cout << "结果" << (sums[0] == sums[1] && sums[1] == sums[2] && sums[2] == sums[3] ? "一致" : "不一致") << std::endl;
+
+	// 在游标处插入：游标每次随机前进几个元素，到尾部回到开头
+	const size_t kInserts = 200000;
+	double ins[2];
+	ins[0] = time_ms([&] {
+		list<int>::iterator cur = l.begin();
+		for (size_t i = 0; i < kInserts; ++i) {
+			for (unsigned step = next_rand(seed) % 8; step != 0 && cur != l.end(); --step) ++cur;
+			if (cur == l.end()) cur = l.begin();
+			l.insert(cur, int(i));
+		}
+	});
+	ins[1] = time_ms([&] {
+		unrolled_list<int>::iterator cur = u.begin();
+		for (size_t i = 0; i < kInserts; ++i) {
+			for (unsigned step = next_rand(seed) % 8; step != 0 && cur != u.end(); --step) ++cur;
+			if (cur == u.end()) cur = u.begin();
+			cur = u.insert(cur, int(i));
+			++cur;
+		}
+	});
+	std::cout << std::endl << "游标处插入 " << kInserts << " 个元素" << std::endl;
+	std::cout << "list\t\t\t" << ins[0] << " ms" << std::endl;
+	std::cout << "unrolled_list\t\t" << ins[1] << " ms  (结点数 " << u.node_count() << ")" << std::endl;
+	return 0;
+}
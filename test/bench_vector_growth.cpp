@@ -0,0 +1,92 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+
+#include "../containers_seqence/vector.h"
+#include "../containers_string/string.h"
+
+using namespace GHYSTL;
+
+// vector<string> push_back 的基准测试，比较扩容时搬动旧元素的三种方式：
+//   复制：移动构造可能抛异常的类型，扩容时只能逐个复制(原来所有类型都走这条路)
+//   移动：移动构造 noexcept 的类型，逐个移动
+//   整块搬动：string 是 is_trivially_relocatable 的，直接 memcpy / realloc
+
+const size_t kElements = 1000000;
+const size_t kRounds = 3;
+
+// 移动构造没有声明 noexcept
+struct copy_string
+{
+	string s;
+	explicit copy_string(string&& x) : s(std::move(x)) {}
+	copy_string(const copy_string& x) : s(x.s) {}
+	copy_string(copy_string&& x) : s(std::move(x.s)) {}
+};
+
+// 移动构造 noexcept，但没有特化 is_trivially_relocatable
+struct move_string
+{
+	string s;
+	explicit move_string(string&& x) : s(std::move(x)) {}
+	move_string(const move_string& x) : s(x.s) {}
+	move_string(move_string&& x) noexcept : s(std::move(x.s)) {}
+};
+
+// 直接包一层 string，可以按字节搬动的性质跟 string 一样
+struct plain_string
+{
+	string s;
+	explicit plain_string(string&& x) : s(std::move(x)) {}
+};
+
+namespace GHYSTL {
+	template<>
+	struct is_trivially_relocatable<plain_string> : is_trivially_relocatable<string> {};
+}
+
+string make_value(size_t i)
+{
+	char buf[64];
+	std::snprintf(buf, sizeof(buf), "value-%08zu-abcdefghijklmnopqrstuvwxyz", i);
+	return string(buf);
+}
+
+template<typename T>
+double run(size_t& checksum)
+{
+	double total = 0;
+	for (size_t r = 0; r < kRounds; ++r) {
+		// 字符串先准备好，计时的只有 push_back(包括扩容)
+		vector<string> src;
+		src.reserve(kElements);
+		for (size_t i = 0; i < kElements; ++i)
+			src.push_back(make_value(i));
+
+		auto start = std::chrono::steady_clock::now();
+		{
+			vector<T> v;
+			for (size_t i = 0; i < kElements; ++i)
+				v.push_back(T(std::move(src[i])));
+			checksum += v.size() + v[kElements / 2].s.size();
+		}
+		auto end = std::chrono::steady_clock::now();
+		total += std::chrono::duration<double, std::milli>(end - start).count();
+	}
+	return total;
+}
+
+int main()
+{
+	size_t checksum = 0;
+
+	double copy_ms = run<copy_string>(checksum);
+	double move_ms = run<move_string>(checksum);
+	double reloc_ms = run<plain_string>(checksum);
+
+	std::cout << "vector<string> push_back " << kElements << " 个元素 x " << kRounds << " 轮" << std::endl;
+	std::cout << "复制(ms)\t移动(ms)\t整块搬动(ms)" << std::endl;
+	std::cout << copy_ms << "\t\t" << move_ms << "\t\t" << reloc_ms << std::endl;
+	std::cout << "checksum = " << checksum << std::endl;
+	return 0;
+}
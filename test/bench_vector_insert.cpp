@@ -0,0 +1,80 @@
+#include <iostream>
+#include <chrono>
+#include <cstdio>
+
+#include "../containers_seqence/vector.h"
+#include "../containers_seqence/list.h"
+#include "../containers_string/string.h"
+
+using namespace GHYSTL;
+
+// 往 1M 个元素的 vector 中间插入 1k 个元素的区间，比较两种做法：
+//   追加再旋转：先把区间 push_back 到尾部，再 rotate 到插入位置(原来 insert/emplace 的做法)
+//   一次后移：insert 把插入位置之后的元素整体后移一次，新元素直接构造在空出来的位置上
+
+const size_t kElements = 1000000;
+const size_t kRange = 1000;
+const size_t kInserts = 50;
+
+template<typename T, typename Iter>
+void append_rotate(vector<T>& v, size_t off, Iter bg, Iter ed)
+{
+	const size_t old_size = v.size();
+	for (; bg != ed; ++bg)
+		v.push_back(*bg);
+	GHYSTL::rotate(v.begin() + off, v.begin() + old_size, v.end());
+}
+
+size_t value_of(int x) { return x; }
+size_t value_of(const string& s) { return s.size() + s[0]; }
+
+template<typename T, typename Src, typename Make>
+void run(const char* title, Make make)
+{
+	Src src;
+	for (size_t i = 0; i < kRange; ++i)
+		src.push_back(make(i));
+
+	double ms[2] = { 0, 0 };
+	size_t checksum[2] = { 0, 0 };
+	for (int way = 0; way < 2; ++way) {
+		vector<T> v;
+		v.reserve(kElements + kRange * kInserts); // 只比较移动元素的开销，不算扩容
+		for (size_t i = 0; i < kElements; ++i)
+			v.push_back(make(i));
+
+		auto start = std::chrono::steady_clock::now();
+		for (size_t i = 0; i < kInserts; ++i) {
+			const size_t off = (i * 7919) % v.size();
+			if (way == 0)
+				append_rotate(v, off, src.begin(), src.end());
+			else
+				v.insert(v.begin() + off, src.begin(), src.end());
+		}
+		auto end = std::chrono::steady_clock::now();
+		ms[way] = std::chrono::duration<double, std::milli>(end - start).count();
+		checksum[way] = v.size();
+		for (size_t i = 0; i < v.size(); i += 1000)
+			checksum[way] += size_t(value_of(v[i]));
+	}
+	std::cout << title << "\t" << ms[0] << "\t\t" << ms[1] << "\t\t"
+		<< (checksum[0] == checksum[1] ? "一致" : "不一致") << std::endl;
+}
+
+string make_string(size_t i)
+{
+	char buf[64];
+	std::snprintf(buf, sizeof(buf), "value-%08zu-abcdefghijklmnopqrstuvwxyz", i);
+	return string(buf);
+}
+
+int main()
+{
+	std::cout << "1M 个元素的 vector 中间插入 " << kInserts << " 次 " << kRange << " 个元素的区间" << std::endl;
+	std::cout << "元素类型(区间)\t追加再旋转(ms)\t一次后移(ms)\t结果" << std::endl;
+	run<int, vector<int>>("int(vector)", [](size_t i) { return int(i); });
+	run<int, list<int>>("int(list)", [](size_t i) { return int(i); });
+	run<string, vector<string>>("string(vector)", make_string);
+	run<string, list<string>>("string(list)", make_string);
+	return 0;
+}
@@ -0,0 +1,110 @@
+#include "../containers_seqence/vector.h"
+#include "../containers_seqence/aligned_vector.h"
+#include "../containers_seqence/list.h"
+#include "../containers_associative/map.h"
+#include "../allocator/allocator.h"
+
+#include <iostream>
+#include <cstdint>
+
+using namespace GHYSTL;
+
+// 每个核一个计数器，按缓存行对齐避免伪共享
+struct alignas(64) counter
+{
+	long value;
+	counter(long v = 0) : value(v) {}
+};
+
+bool aligned(const void* p, size_t n) { return (reinterpret_cast<std::uintptr_t>(p) & (n - 1)) == 0; }
+
+int main()
+{
+	std::cout << "-----------------alignas(64) 的类型----------------" << std::endl;
+	{
+		vector<counter> v;
+		bool ok = true;
+		for (int i = 0; i < 1000; ++i) {
+			v.push_back(counter(i));
+			ok = ok && aligned(&v[0], 64);
+		}
+		long sum = 0;
+		for (size_t i = 0; i < v.size(); ++i) sum += v[i].value;
+		std::cout << "扩容过程中首地址都按 64 字节对齐: " << ok << "  元素和: " << sum << std::endl;
+
+		list<counter> lst;
+		ok = true;
+		for (int i = 0; i < 100; ++i) {
+			lst.push_back(counter(i));
+			ok = ok && aligned(&lst.back(), 64);
+		}
+		std::cout << "list 的结点按 64 字节对齐: " << ok << std::endl;
+	}
+
+	std::cout << std::endl << "-----------------aligned_allocator----------------" << std::endl;
+	{
+		vector<float, aligned_allocator<float, 32>> v32;
+		vector<double, aligned_allocator<double, 64>> v64;
+		bool ok = true;
+		for (int i = 0; i < 10000; ++i) {
+			v32.push_back(i * 0.5f);
+			v64.push_back(i * 0.25);
+			ok = ok && aligned(&v32[0], 32) && aligned(&v64[0], 64);
+		}
+		v32.shrink_to_fit();
+		ok = ok && aligned(&v32[0], 32);
+		std::cout << "float 按 32 字节对齐、double 按 64 字节对齐: " << ok << std::endl;
+		std::cout << "v32[9999] = " << v32[9999] << "  v64[9999] = " << v64[9999] << std::endl;
+
+		// 元素类型要求 64 字节对齐，结点里的元素也落在 64 字节边界上
+		map<int, counter, less<int>, aligned_allocator<pair<const int, counter>, 64>> m;
+		int keys[] = { 5, 3, 8, 1, 4 };
+		for (int k : keys) m.insert(pair<const int, counter>(k, counter(k * k)));
+		ok = true;
+		for (auto it = m.begin(); it != m.end(); ++it) {
+			ok = ok && aligned(&it->second, 64);
+			std::cout << it->first << ":" << it->second.value << " ";
+		}
+		std::cout << std::endl << "map 的元素按 64 字节对齐: " << ok << std::endl;
+	}
+
+	std::cout << std::endl << "-----------------aligned_vector----------------" << std::endl;
+	{
+		aligned_vector<float, 32> v;
+		bool ok = true;
+		for (int i = 0; i < 1000; ++i) {
+			v.push_back(float(999 - i));
+			ok = ok && aligned(v.data(), 32) && v.capacity() % 8 == 0;
+		}
+		std::cout << "首地址按 32 字节对齐、容量是 8 个 float 的整数倍: " << ok << "  capacity = " << v.capacity() << std::endl;
+
+		v.resize(13);
+		v.shrink_to_fit();
+		std::cout << "resize(13) 后 shrink_to_fit: capacity = " << v.capacity() << "  padded_size = " << padded_size(v) << std::endl;
+
+		// 按整个 SIMD 宽度处理，补齐的部分不越界
+		float* p = v.data();
+		for (size_t i = v.size(); i < padded_size(v); ++i) p[i] = 0;
+		float lanes[8] = { 0 };
+		for (size_t i = 0; i < padded_size(v); i += simd_width<float, 32>::value)
+			for (int k = 0; k < 8; ++k) lanes[k] += p[i + k];
+		float sum = 0;
+		for (int k = 0; k < 8; ++k) sum += lanes[k];
+
+		std::cout << "按 8 个一组求和: " << sum << "  accumulate: " << accumulate(v.begin(), v.end(), 0.0f) << std::endl;
+	}
+
+	std::cout << std::endl << "-----------------arena 上的对齐分配----------------" << std::endl;
+	{
+		monotonic_arena arena(256);
+		arena_allocator<counter> a(arena);
+		vector<counter, arena_allocator<counter>> v(a);
+		bool ok = true;
+		for (int i = 0; i < 100; ++i) {
+			v.push_back(counter(i));
+			ok = ok && aligned(&v[0], 64);
+		}
+		std::cout << "arena 上的 vector 按 64 字节对齐: " << ok << "  v[99] = " << v[99].value << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,54 @@
+#define GHYSTL_ALLOC_STATS
+
+#include "../containers_seqence/list.h"
+#include "../containers_associative/map.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+void print_stats(const alloc_stats& st)
+{
+	std::cout << "类别\t分配\t释放" << std::endl;
+	for (size_t i = 0; i < _NFREELIST; ++i) {
+		if (st.allocs[i] == 0 && st.frees[i] == 0) continue;
+		std::cout << st.class_bytes[i] << "\t" << st.allocs[i] << "\t" << st.frees[i] << std::endl;
+	}
+	std::cout << "大区块分配/释放: " << st.large_allocs << "/" << st.large_frees << std::endl;
+	std::cout << "refill 次数: " << st.refills << "  向系统申请大块次数: " << st.chunk_mallocs
+		<< "  oom 次数: " << st.oom_mallocs << std::endl;
+	std::cout << "内存池总量: " << st.heap_size << "  未切分: " << st.pool_bytes
+		<< "  自由链表: " << st.free_list_bytes << std::endl;
+	std::cout << "分配出去(小/大): " << st.small_bytes << "/" << st.large_bytes
+		<< "  峰值: " << st.peak_bytes << std::endl;
+}
+
+int main()
+{
+	std::cout << "-----------------空配置器----------------" << std::endl;
+	print_stats(default_alloc::stats());
+
+	{
+		list<int> lst;
+		map<int, int> mp;
+		for (int i = 0; i < 1000; ++i) {
+			lst.push_back(i);
+			mp.insert(pair<const int, int>(i, i));
+		}
+		void* big = default_alloc::allocate(1000);
+
+		std::cout << std::endl << "-----------------插入1000个元素后----------------" << std::endl;
+		print_stats(default_alloc::stats());
+		default_alloc::deallocate(big, 1000);
+	}
+
+	std::cout << std::endl << "-----------------容器析构后----------------" << std::endl;
+	alloc_stats st = default_alloc::stats();
+	print_stats(st);
+
+	// 全部归还之后，切分出去的空间应该都挂在自由链表上
+	bool ok = st.small_bytes == 0 && st.large_bytes == 0
+		&& st.free_list_bytes + st.pool_bytes == st.heap_size;
+	std::cout << (ok ? "统计一致" : "统计不一致") << std::endl;
+	return ok ? 0 : 1;
+}
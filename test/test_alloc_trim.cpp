@@ -0,0 +1,57 @@
+#include "../containers_seqence/list.h"
+#include "../allocator/alloc.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+void print_pool(const char* title)
+{
+	alloc_stats st = default_alloc::stats();
+	std::cout << title << "  内存池总量: " << st.heap_size << "  大块个数: " << st.chunk_count
+		<< "  未切分: " << st.pool_bytes << std::endl;
+}
+
+int main()
+{
+	std::cout << "-----------------手动 trim----------------" << std::endl;
+	{
+		list<int> lst;
+		for (int i = 0; i < 100000; ++i) lst.push_back(i);
+		print_pool("插入100000个元素后");
+	}
+	print_pool("list析构后");
+	size_t released = default_alloc::trim();
+	std::cout << "trim 归还字节数: " << released << std::endl;
+	print_pool("trim后");
+
+	std::cout << std::endl << "-----------------部分区块仍在使用----------------" << std::endl;
+	{
+		list<int> keep;
+		{
+			list<int> tmp;
+			for (int i = 0; i < 100000; ++i) {
+				tmp.push_back(i);
+				if (i % 1000 == 0) keep.push_back(i);
+			}
+		}
+		released = default_alloc::trim();
+		std::cout << "trim 归还字节数 > 0: " << (released > 0) << std::endl;
+		long sum = 0;
+		for (list<int>::iterator it = keep.begin(); it != keep.end(); ++it) sum += *it;
+		std::cout << "保留的元素个数: " << keep.size() << "  元素和: " << sum << std::endl;
+	}
+	default_alloc::trim();
+	print_pool("全部析构并trim后");
+
+	std::cout << std::endl << "-----------------水位线自动 trim----------------" << std::endl;
+	default_alloc::set_trim_watermark(64 * 1024);
+	{
+		list<int> lst;
+		for (int i = 0; i < 100000; ++i) lst.push_back(i);
+	}
+	alloc_stats st = default_alloc::stats();
+	std::cout << "自动 trim 后内存池总量不超过 1MB: " << (st.heap_size <= 1024 * 1024) << std::endl;
+	default_alloc::set_trim_watermark(0);
+	return 0;
+}
@@ -0,0 +1,177 @@
+#define GHYSTL_ALLOC_STATS
+
+#include "../containers_seqence/list.h"
+#include "../containers_associative/set.h"
+#include "../containers_associative/map.h"
+#include "../containers_associative/unordered_set.h"
+#include "../containers_associative/unordered_map.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// 批量申请、释放节点之后，配置器的分配次数和释放次数要对得上；
+// 范围插入重复的 key 时多申请的节点要还回去，桶数也不能按重复的个数算
+
+// 还没有还回配置器的区块个数
+size_t outstanding()
+{
+	alloc_stats st = default_alloc::stats();
+	size_t n = st.large_allocs - st.large_frees;
+	for (size_t i = 0; i < _NFREELIST; ++i)
+		n += st.allocs[i] - st.frees[i];
+	return n;
+}
+
+struct node24 { void* link; int a[4]; };
+
+// 没有批量接口的分配器，allocate_nodes / deallocate_nodes 退化为逐个申请释放
+struct single_alloc
+{
+	typedef node24* pointer;
+	static size_t live;
+	pointer allocate() { ++live; return static_cast<pointer>(default_alloc::allocate(sizeof(node24))); }
+	void deallocate(pointer p) { --live; default_alloc::deallocate(p, sizeof(node24)); }
+};
+size_t single_alloc::live = 0;
+
+template<typename Alloc>
+bool round_trip(Alloc& a, size_t n)
+{
+	typename Alloc::pointer head = allocate_nodes(a, n);
+	size_t cnt = 0;
+	for (typename Alloc::pointer p = head; p; p = batch_next(p))
+		++cnt;
+	deallocate_nodes(a, head);
+	return cnt == n;
+}
+
+int main()
+{
+	int errors = 0;
+
+	/*---------------------------------------------- 批量申请、释放 ----------------------------------------------*/
+	{
+		const size_t before = outstanding();
+		allocator<node24> a;
+		single_alloc s;
+		bool ok = true;
+		const size_t sizes[] = { 0, 1, 2, 7, 64, 1000, 5000 };
+		for (size_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); ++i) {
+			ok = round_trip(a, sizes[i]) && ok;
+			ok = round_trip(s, sizes[i]) && ok;
+		}
+		const size_t after = outstanding();
+		std::cout << "批量申请的链表长度正确: " << (ok ? "是" : "否")
+			<< "  未归还的区块: " << after - before << "  逐个分配的未归还: " << single_alloc::live << std::endl;
+		if (!ok || after != before || single_alloc::live != 0)
+			++errors;
+	}
+
+	/*---------------------------------------------- 范围插入重复的 key ----------------------------------------------*/
+	{
+		const size_t before = outstanding();
+		int keys[3000];
+		for (int i = 0; i < 3000; ++i)
+			keys[i] = i % 3;
+		{
+			unordered_set<int> us;
+			us.insert(keys, keys + 3000);
+			unordered_multiset<int> ums;
+			ums.insert(keys, keys + 3000);
+			set<int> st;
+			st.insert(keys, keys + 3000);
+			list<int> ls;
+			ls.insert(ls.end(), keys, keys + 3000);
+
+			std::cout << "unordered_set size: " << us.size() << "  桶数不超过 100: " << (us.bucket_count() <= 100 ? "是" : "否")
+				<< "  count(2): " << us.count(2) << std::endl;
+			std::cout << "unordered_multiset size: " << ums.size() << "  count(2): " << ums.count(2)
+				<< "  桶数不少于元素个数: " << (ums.bucket_count() >= ums.size() ? "是" : "否") << std::endl;
+			std::cout << "set size: " << st.size() << "  list size: " << ls.size() << std::endl;
+			if (us.size() != 3 || us.bucket_count() > 100 || ums.size() != 3000 || st.size() != 3 || ls.size() != 3000)
+				++errors;
+
+			// 已有元素的表再插一批，新 key 和重复 key 混在一起
+			int more[100];
+			for (int i = 0; i < 100; ++i)
+				more[i] = i / 2;
+			us.insert(more, more + 100);
+			st.insert(more, more + 100);
+			std::cout << "再插入 50 个不同的 key 后 unordered_set size: " << us.size() << "  set size: " << st.size() << std::endl;
+			if (us.size() != 50 || st.size() != 50)
+				++errors;
+		}
+		const size_t after = outstanding();
+		std::cout << "重复 key 的范围插入后未归还的区块: " << after - before << std::endl;
+		if (after != before)
+			++errors;
+	}
+
+	/*---------------------------------------------- 拷贝、清空 ----------------------------------------------*/
+	{
+		const size_t before = outstanding();
+		{
+			set<int> st;
+			map<int, int> mp;
+			unordered_map<int, int> um;
+			list<int> ls;
+			for (int i = 0; i < 500; ++i) {
+				st.insert(i * 7 % 500);
+				mp[i] = i * i;
+				um[i] = -i;
+				ls.push_back(i);
+			}
+
+			set<int> st2(st);
+			map<int, int> mp2(mp);
+			unordered_map<int, int> um2(um);
+			list<int> ls2(ls);
+
+			bool same = st2.size() == 500 && mp2.size() == 500 && um2.size() == 500 && ls2.size() == 500;
+			int expect = 0;
+			for (set<int>::iterator it = st2.begin(); it != st2.end(); ++it)
+				same = same && *it == expect++;
+			for (int i = 0; i < 500; ++i)
+				same = same && mp2[i] == i * i && um2[i] == -i;
+			expect = 0;
+			for (list<int>::iterator it = ls2.begin(); it != ls2.end(); ++it)
+				same = same && *it == expect++;
+			std::cout << "拷贝后的元素与原容器一致: " << (same ? "是" : "否") << std::endl;
+
+			// 拷贝赋值覆盖已有元素
+			set<int> st3;
+			st3.insert(-1);
+			st3 = st;
+			map<int, int> mp3;
+			mp3[-1] = 0;
+			mp3 = mp;
+			std::cout << "拷贝赋值后 set size: " << st3.size() << "  map size: " << mp3.size()
+				<< "  begin: " << *st3.begin() << std::endl;
+			if (!same || st3.size() != 500 || mp3.size() != 500 || *st3.begin() != 0)
+				++errors;
+
+			st.clear();
+			mp.clear();
+			um.clear();
+			ls.clear();
+			std::cout << "清空原容器后拷贝的 size: " << st2.size() << " " << mp2.size() << " " << um2.size() << " " << ls2.size()
+				<< "  原容器 empty: " << (st.empty() && mp.empty() && um.empty() && ls.empty() ? "是" : "否") << std::endl;
+
+			// 清空之后还能继续用
+			st.insert(1);
+			um[1] = 1;
+			ls.push_back(1);
+			std::cout << "清空后再插入的 size: " << st.size() << " " << um.size() << " " << ls.size() << std::endl;
+			if (st2.size() != 500 || um2.size() != 500 || ls2.size() != 500 || st.size() != 1 || um.size() != 1 || ls.size() != 1)
+				++errors;
+		}
+		const size_t after = outstanding();
+		std::cout << "拷贝、清空后未归还的区块: " << after - before << std::endl;
+		if (after != before)
+			++errors;
+	}
+
+	std::cout << "错误个数: " << errors << std::endl;
+	return errors;
+}
@@ -106,6 +106,25 @@ int main(){
 	std::cout << "长度：" << test.size() << std::endl;
 	std::cout << std::endl;
 
+	/***************************************************************************************/
+	/***************************************************************************************/
+	std::cout << "************************指定缓冲区大小测试************************" << std::endl;
+	std::cout << std::endl;
+	std::cout << "默认缓冲区大小(int)：" << deque<int>::buffer_size << std::endl;
+	deque<int, allocator<int>, 8> small; // 每个缓冲区 8 个元素
+	for (int i = 0; i < 20; i++){
+		small.push_back(i);
+		small.push_front(-i - 1);
+	}
+	std::cout << "缓冲区大小 8，前后各插入 20 个，每隔 5 个取一次下标：";
+	for (size_t i = 0; i < small.size(); i += 5){
+		std::cout << small[i] << ",";
+	}
+	std::cout << std::endl;
+	deque<int, allocator<int>, 8>::iterator it = small.end() - 17;
+	std::cout << "end() - 17：" << *it << "  (it + 9) - begin()：" << (it + 9) - small.begin() << std::endl;
+	std::cout << std::endl;
+
 	std::cout << "************************测试结束************************" << std::endl;
 	std::cout << std::endl;
 	system("pause");
@@ -0,0 +1,92 @@
+#define GHYSTL_ALLOC_STATS
+
+#include "../containers_seqence/queue.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// queue 一头进一头出：头部空出来的缓冲区留作备用给尾部用，map 到头时挪回中间，
+// 预热之后不应该再向配置器申请任何空间
+
+size_t total_allocs()
+{
+	alloc_stats st = default_alloc::stats();
+	size_t n = st.large_allocs;
+	for (size_t i = 0; i < _NFREELIST; ++i)
+		n += st.allocs[i];
+	return n;
+}
+
+// 还没有还回配置器的区块个数
+size_t outstanding()
+{
+	alloc_stats st = default_alloc::stats();
+	size_t n = st.large_allocs - st.large_frees;
+	for (size_t i = 0; i < _NFREELIST; ++i)
+		n += st.allocs[i] - st.frees[i];
+	return n;
+}
+
+// 区间删除、resize 变小之后空出来的缓冲区要还回去，析构后不能有泄漏
+bool erase_range_check()
+{
+	const size_t before = outstanding();
+	bool ok = true;
+	{
+		deque<int> a, b, c, d;
+		for (int i = 0; i < 10000; ++i) {
+			a.push_back(i);
+			b.push_back(i);
+			c.push_back(i);
+			d.push_back(i);
+		}
+		a.erase(a.begin() + 10, a.end());       // 删掉后面，搬动后面的元素
+		b.erase(b.begin(), b.end() - 10);       // 删掉前面，搬动前面的元素
+		c.resize(3);
+		d.erase(d.begin() + 100, d.end() - 9000); // 删掉中间，前面元素少
+		ok = a.size() == 10 && a.back() == 9 && b.size() == 10 && b.front() == 9990
+			&& c.size() == 3 && c.back() == 2 && d.size() == 9100 && d[99] == 99 && d[100] == 1000;
+
+		// 删完之后两头继续增长
+		for (int i = 0; i < 5000; ++i) {
+			a.push_front(-i);
+			b.push_back(i);
+		}
+		ok = ok && a.size() == 5010 && a.front() == -4999 && b.size() == 5010 && b.back() == 4999;
+		std::cout << "区间删除后 size: " << a.size() << " " << b.size() << " " << c.size() << " " << d.size() << std::endl;
+	}
+	const size_t after = outstanding();
+	std::cout << "区间删除、resize 变小后未归还的区块: " << after - before << std::endl;
+	return ok && after == before;
+}
+
+int main()
+{
+	const bool erase_ok = erase_range_check();
+
+	queue<int> q;
+	for (int i = 0; i < 3000; ++i)
+		q.push(i);
+
+	// 预热：让队列整体往后滑过几个缓冲区
+	long long sum = 0;
+	for (int i = 0; i < 10000; ++i) {
+		sum += q.front();
+		q.pop();
+		q.push(i);
+	}
+
+	const size_t before = total_allocs();
+	for (int i = 0; i < 1000000; ++i) {
+		sum += q.front();
+		q.pop();
+		q.push(i);
+	}
+	const size_t after = total_allocs();
+
+	std::cout << "队列长度: " << q.size() << "  缓冲区大小: " << deque<int>::buffer_size << std::endl;
+	std::cout << "稳定后 100 万次出队入队的分配次数: " << after - before << std::endl;
+	std::cout << "校验和: " << sum << std::endl;
+	return after == before && erase_ok ? 0 : 1;
+}
@@ -0,0 +1,51 @@
+#include "../containers_seqence/vector.h"
+#include "../containers_string/string.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// 打印 push_back 过程中容量变化的序列
+template<typename Vec>
+void print_growth(const char* title, size_t n)
+{
+	Vec v;
+	size_t cap = v.capacity();
+	size_t reallocs = 0;
+	std::cout << title << ": ";
+	for (size_t i = 0; i < n; ++i) {
+		v.push_back(typename Vec::value_type());
+		if (v.capacity() != cap) {
+			cap = v.capacity();
+			++reallocs;
+			std::cout << cap << " ";
+		}
+	}
+	std::cout << " (扩容 " << reallocs << " 次)" << std::endl;
+}
+
+int main()
+{
+	std::cout << "-----------------vector<int>----------------" << std::endl;
+	print_growth<vector<int>>("2x(默认)", 1000);
+	print_growth<vector<int, allocator<int>, growth_half>>("1.5x", 1000);
+	print_growth<vector<int, allocator<int>, growth_size_class<>>>("2x + 按区块取整", 1000);
+	print_growth<vector<int, allocator<int>, growth_size_class<growth_half>>>("1.5x + 按区块取整", 1000);
+
+	std::cout << std::endl << "-----------------vector<double> 按区块取整----------------" << std::endl;
+	print_growth<vector<double, allocator<double>, growth_size_class<growth_half>>>("1.5x + 按区块取整", 1000);
+
+	std::cout << std::endl << "-----------------string----------------" << std::endl;
+	{
+		string s;
+		base_string<char, char_traits<char>, allocator<char>, growth_size_class<growth_half>> r;
+		for (int i = 0; i < 300; ++i) {
+			s.push_back('a' + i % 26);
+			r.push_back('a' + i % 26);
+		}
+		std::cout << "1.5x(默认) 容量: " << s.capacity() << std::endl;
+		std::cout << "1.5x + 按区块取整 容量: " << r.capacity() << std::endl;
+		std::cout << "内容一致: " << (s == string(r.c_str())) << "  长度: " << r.size() << std::endl;
+	}
+	return 0;
+}
@@ -0,0 +1,92 @@
+#include "../containers_seqence/intrusive_list.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// 同一个定时器可以同时挂在"全部定时器"和"到期定时器"两条链表上
+struct timer
+{
+	int id;
+	list_hook all_hook;
+	list_hook ready_hook;
+
+	explicit timer(int id = 0) : id(id) {}
+};
+
+typedef intrusive_list<timer, &timer::all_hook>		all_list;
+typedef intrusive_list<timer, &timer::ready_hook>	ready_list;
+
+template<typename List>
+void print(const char* title, const List& l)
+{
+	std::cout << title << ": ";
+	for (auto it = l.begin(); it != l.end(); ++it)
+		std::cout << it->id << " ";
+	std::cout << " (size " << l.size() << ")" << std::endl;
+}
+
+int main()
+{
+	timer pool[8];
+	for (int i = 0; i < 8; ++i)
+		pool[i].id = i;
+
+	std::cout << "-----------------插入和遍历----------------" << std::endl;
+	all_list all;
+	ready_list ready;
+	for (int i = 0; i < 8; ++i)
+		all.push_back(pool[i]);
+	ready.push_back(pool[5]);
+	ready.push_front(pool[2]);
+	print("all", all);
+	print("ready", ready);
+	std::cout << "反向遍历 all: ";
+	for (auto it = all.rbegin(); it != all.rend(); ++it)
+		std::cout << it->id << " ";
+	std::cout << std::endl;
+
+	std::cout << std::endl << "-----------------按引用删除----------------" << std::endl;
+	all.erase(pool[5]);
+	all.erase(pool[0]);
+	print("all 删除 5 和 0", all);
+	print("ready 不受影响", ready);
+	std::cout << "pool[5] 在 all 里: " << pool[5].all_hook.is_linked()
+		<< "  在 ready 里: " << pool[5].ready_hook.is_linked() << std::endl;
+
+	std::cout << std::endl << "-----------------splice----------------" << std::endl;
+	all_list other;
+	other.push_back(pool[0]);
+	other.push_back(pool[5]);
+	all.splice(all.begin(), other);
+	print("other 整个移到 all 开头", all);
+	print("other", other);
+	all.splice(all.end(), all, all.iterator_to(pool[3]));
+	print("3 移到末尾", all);
+	auto first = all.iterator_to(pool[1]);
+	auto last = all.iterator_to(pool[3]);
+	other.splice(other.end(), all, first, last);
+	print("[1, 3) 移到 other", other);
+	print("all", all);
+
+	std::cout << std::endl << "-----------------reverse、remove_if、move----------------" << std::endl;
+	all.reverse();
+	print("all 反转", all);
+	all.remove_if([](const timer& t) { return t.id % 2 == 0; });
+	print("all 删除偶数", all);
+	all_list moved(std::move(all));
+	print("移动构造", moved);
+	print("移动后的 all", all);
+	moved.swap(other);
+	print("交换后 moved", moved);
+	print("交换后 other", other);
+
+	moved.clear();
+	other.clear();
+	ready.clear();
+	int linked = 0;
+	for (int i = 0; i < 8; ++i)
+		linked += pool[i].all_hook.is_linked() + pool[i].ready_hook.is_linked();
+	std::cout << "clear 之后仍在链表里的 hook 数: " << linked << std::endl;
+	return 0;
+}
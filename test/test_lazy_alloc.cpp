@@ -0,0 +1,109 @@
+#define GHYSTL_ALLOC_STATS
+
+#include "../containers_seqence/deque.h"
+#include "../containers_string/string.h"
+#include "../containers_associative/unordered_map.h"
+#include "../containers_associative/unordered_set.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// 默认构造的 deque、string、unordered_map 不向配置器申请空间，
+// 第一次插入时才分配，之后的行为和原来一样
+
+size_t total_allocs()
+{
+	alloc_stats st = default_alloc::stats();
+	size_t n = st.large_allocs;
+	for (size_t i = 0; i < _NFREELIST; ++i)
+		n += st.allocs[i];
+	return n;
+}
+
+int main()
+{
+	const size_t before = total_allocs();
+	{
+		deque<int> d[1000];
+		string s[1000];
+		unordered_map<int, int> m[1000];
+
+		size_t n = 0;
+		for (int i = 0; i < 1000; ++i) {
+			n += d[i].size() + s[i].size() + m[i].size();
+			if (d[i].begin() != d[i].end() || s[i].c_str()[0] != '\0' || m[i].find(i) != m[i].end())
+				++n;
+			d[i].clear();
+			s[i].clear();
+			m[i].clear();
+		}
+
+		deque<int> d2(d[0]);
+		string s2(s[0]);
+		unordered_map<int, int> m2(m[0]);
+		n += d2.size() + s2.size() + m2.size() + m2.count(1) + m2.erase(1);
+		std::cout << "3000 个空容器及其拷贝的元素个数: " << n << std::endl;
+	}
+	const size_t after = total_allocs();
+	std::cout << "默认构造 3000 个空容器的分配次数: " << after - before << std::endl;
+
+	// 没有桶的哈希表上调用所有要算 hash 的成员
+	{
+		unordered_map<int, int> hm;
+		const unordered_map<int, int>& chm = hm;
+		unordered_set<int> hs;
+		size_t n = hm.bucket(5) + hm.count(5) + hm.erase(5) + hs.bucket(5) + hs.count(5) + hs.erase(5);
+		if (hm.find(5) != hm.end() || chm.find(5) != chm.end() || hs.find(5) != hs.end())
+			++n;
+		if (hm.equal_range(5).first != hm.equal_range(5).second || chm.equal_range(5).first != chm.equal_range(5).second)
+			++n;
+		hm.clear();
+		hs.clear();
+		std::cout << "空哈希表按 key 查找、计数、删除、取桶号的结果之和: " << n
+			<< "  load_factor: " << hm.load_factor() << std::endl;
+	}
+
+	// 第一次插入
+	deque<int> d;
+	d.push_front(1);
+	d.push_back(2);
+	d.emplace_back(3);
+	std::cout << "deque:";
+	for (deque<int>::iterator it = d.begin(); it != d.end(); ++it)
+		std::cout << " " << *it;
+	std::cout << std::endl;
+
+	deque<int> d3;
+	d3.insert(d3.end(), 3, 7);
+	std::cout << "deque insert(end, 3, 7) 后长度: " << d3.size() << "  back: " << d3.back() << std::endl;
+
+	string s;
+	std::cout << "空 string 的 c_str 长度: " << char_traits<char>::length(s.c_str()) << std::endl;
+	string w1, w2;
+	w1[w1.size()] = 'z'; // 写结束符的位置不能影响别的空字符串
+	std::cout << "写过 s[size()] 之后另一个空 string 的 c_str 长度: " << char_traits<char>::length(w2.c_str())
+		<< "  自己的 size: " << w1.size() << std::endl;
+	// 空 string 上第一次 replace 要扩容，扩容后插入点按下标重新定位
+	string r1, r2, r3;
+	const char src[] = "world";
+	r1.replace(r1.begin(), r1.end(), "hello");
+	r2.replace(r2.begin(), r2.end(), 3, 'x');
+	r3.replace(r3.begin(), r3.end(), src, src + 5);
+	std::cout << "空 string replace: " << r1.c_str() << " " << r2.c_str() << " " << r3.c_str() << std::endl;
+	r1.replace(r1.begin() + 2, r1.begin() + 3, "-0123456789abcdefghijklmnopqrstuvwxyz-");
+	std::cout << "扩容的 replace: " << r1.c_str() << std::endl;
+	s.push_back('a');
+	s.append("bc");
+	s.insert(s.begin(), 'x');
+	std::cout << "string: " << s.c_str() << "  容量不小于 35: " << (s.capacity() >= 35 ? "是" : "否") << std::endl;
+
+	unordered_map<int, int> m;
+	std::cout << "空 unordered_map 的桶数: " << m.bucket_count() << std::endl;
+	for (int i = 0; i < 10; ++i)
+		m[i] = i * i;
+	std::cout << "unordered_map: size " << m.size() << "  m[7] = " << m[7] << "  桶数不为 0: "
+		<< (m.bucket_count() != 0 ? "是" : "否") << std::endl;
+
+	return after == before ? 0 : 1;
+}
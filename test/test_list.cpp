@@ -63,6 +63,44 @@ int main()
 		i++;
 	}
 
+	std::cout << std::endl << std::endl << "-----------------splice 和 merge----------------" << std::endl;
+	list<int> a, b;
+	for (i = 0; i < 10; i += 2) a.push_back(i); // 0 2 4 6 8
+	for (i = 1; i < 10; i += 2) b.push_back(i); // 1 3 5 7 9
+	a.merge(b);
+	std::cout << "merge 后 a 的长度:" << a.size() << "  b 的长度:" << b.size() << std::endl;
+	list<int>::iterator first = a.begin();
+	list<int>::iterator last = a.begin();
+	for (i = 0; i < 4; ++i) ++last;
+	b.splice(b.end(), a, first, last); // 把 a 的前四个移到 b
+	b.splice(b.begin(), a, --a.end());  // 把 a 的最后一个移到 b 的开头
+	std::cout << "splice 后 a 的长度:" << a.size() << "  b 的长度:" << b.size() << std::endl;
+	for (list<int>::iterator iter = b.begin(); iter != b.end(); iter++)
+		std::cout << *iter << " ";
+	std::cout << std::endl;
+	a.splice(a.begin(), b);
+	a.resize(12, -1);
+	std::cout << "全部移回 a 再 resize(12, -1) 后 a 的长度:" << a.size() << "  b 的长度:" << b.size() << std::endl;
+
+	std::cout << std::endl << std::endl << "-----------------sort----------------" << std::endl;
+	a.sort();
+	std::cout << "从小到大:";
+	for (list<int>::iterator iter = a.begin(); iter != a.end(); iter++)
+		std::cout << " " << *iter;
+	std::cout << std::endl;
+	a.sort(greater<int>());
+	std::cout << "从大到小:";
+	for (list<int>::iterator iter = a.begin(); iter != a.end(); iter++)
+		std::cout << " " << *iter;
+	std::cout << std::endl;
+	list<int> big;
+	for (i = 0; i < 100000; ++i) big.push_back((i * 7919) % 100003);
+	big.sort();
+	bool sorted = true;
+	for (list<int>::iterator iter = big.begin(), prev = iter++; iter != big.end(); prev = iter++)
+		if (*iter < *prev) sorted = false;
+	std::cout << "100000 个元素排序后" << (sorted ? "有序" : "无序") << "，长度:" << big.size() << std::endl;
+
 	system("pause");
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,82 @@
+#include "../containers_seqence/mmap_vector.h"
+#include "../algorithm/algo_numeric.h"
+
+#include <iostream>
+#include <cstdio>
+
+using namespace GHYSTL;
+
+struct entry
+{
+	int key;
+	double value;
+};
+
+const char* kPath = "test_mmap_vector.bin";
+
+int main()
+{
+	std::remove(kPath);
+
+	std::cout << "-----------------读写映射，写入文件----------------" << std::endl;
+	{
+		mmap_vector<int> v(kPath, mmap_read_write);
+		std::cout << "新文件: size = " << v.size() << "  capacity = " << v.capacity() << std::endl;
+		for (int i = 0; i < 100000; ++i)
+			v.push_back((i * 7919) % 100003);
+		std::cout << "push_back 100000 个: size = " << v.size() << "  capacity = " << v.capacity() << std::endl;
+		GHYSTL::sort(v.begin(), v.end());
+		std::cout << "排序后 front = " << v.front() << "  back = " << v.back() << std::endl;
+		v.pop_back();
+	} // 析构时把文件截到 size() 个元素
+
+	std::cout << std::endl << "-----------------只读映射，直接使用----------------" << std::endl;
+	{
+		mmap_vector<int> v(kPath);
+		std::cout << "size = " << v.size() << "  capacity = " << v.capacity() << "  可写: " << v.writable() << std::endl;
+		mmap_vector<int>::const_iterator pos = lower_bound(v.begin(), v.end(), 50000);
+		std::cout << "lower_bound(50000) 在第 " << (pos - v.begin()) << " 个" << std::endl;
+		long long sum = accumulate(v.begin(), v.end(), 0LL);
+		std::cout << "元素和: " << sum << std::endl;
+		try {
+			v.push_back(1);
+		}
+		catch (const std::runtime_error& e) {
+			std::cout << "只读时 push_back: " << e.what() << std::endl;
+		}
+	}
+
+	std::cout << std::endl << "-----------------写时复制，不改动文件----------------" << std::endl;
+	{
+		mmap_vector<int> v(kPath, mmap_copy_on_write);
+		GHYSTL::sort(v.begin(), v.end(), greater<int>());
+		std::cout << "映射里从大到小排序后 front = " << v.front() << std::endl;
+	}
+	{
+		mmap_vector<int> v(kPath);
+		std::cout << "文件里的 front 还是 " << v.front() << std::endl;
+	}
+
+	std::cout << std::endl << "-----------------结构体----------------" << std::endl;
+	{
+		mmap_vector<entry> v(kPath, mmap_read_write);
+		v.clear();
+		v.resize(3);
+		v[1].key = 7;
+		v[1].value = 2.5;
+		entry e = { 9, 0.25 };
+		v.push_back(e);
+		v.shrink_to_fit();
+		v.flush();
+		std::cout << "size = " << v.size() << "  capacity = " << v.capacity() << std::endl;
+	}
+	{
+		mmap_vector<entry> v(kPath);
+		for (mmap_vector<entry>::const_iterator it = v.begin(); it != v.end(); ++it)
+			std::cout << it->key << ":" << it->value << " ";
+		std::cout << std::endl;
+	}
+
+	std::remove(kPath);
+	return 0;
+}
@@ -0,0 +1,62 @@
+#include "../containers_seqence/list.h"
+#include "../containers_associative/map.h"
+#include "../containers_associative/unordered_map.h"
+#include "../allocator/allocator.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+template<typename Alloc>
+void print_pool(const char* title)
+{
+	node_pool_stats st = Alloc::stats();
+	std::cout << title << "  槽位大小: " << st.slot_size << "  页数: " << st.pages
+		<< "  容量: " << st.capacity << "  使用中: " << st.in_use << "  峰值: " << st.peak_in_use
+		<< "  分配/释放: " << st.allocs << "/" << st.frees << std::endl;
+}
+
+int main()
+{
+	typedef node_pool_allocator<int> int_pool;
+	typedef list<int, int_pool> pool_list;
+	typedef pool_list::node_alloc list_pool;
+
+	std::cout << "-----------------list----------------" << std::endl;
+	{
+		pool_list lst;
+		for (int i = 0; i < 10000; ++i) lst.push_back(i);
+		print_pool<list_pool>("插入10000个元素后");
+		for (int i = 0; i < 5000; ++i) lst.pop_front();
+		print_pool<list_pool>("删除5000个元素后");
+		for (int i = 0; i < 5000; ++i) lst.push_back(i);
+		print_pool<list_pool>("再插入5000个元素后(复用空闲槽位)");
+		long sum = 0;
+		for (pool_list::iterator it = lst.begin(); it != lst.end(); ++it) sum += *it;
+		std::cout << "元素和: " << sum << std::endl;
+	}
+	print_pool<list_pool>("list析构后");
+
+	std::cout << std::endl << "-----------------map----------------" << std::endl;
+	typedef map<int, int, less<int>, node_pool_allocator<pair<const int, int>>> pool_map;
+	{
+		pool_map m;
+		for (int i = 0; i < 1000; ++i) m.insert(pair<const int, int>(i, i * 2));
+		pool_map m2(m); // 批量分配结点
+		long sum = 0;
+		for (auto it = m2.begin(); it != m2.end(); ++it) sum += it->second;
+		std::cout << "m2.size() = " << m2.size() << "  值的和: " << sum << std::endl;
+		print_pool<node_pool_allocator<rb_tree_node<pair<const int, int>>>>("两个map");
+	}
+	print_pool<node_pool_allocator<rb_tree_node<pair<const int, int>>>>("map析构后");
+
+	std::cout << std::endl << "-----------------unordered_map----------------" << std::endl;
+	{
+		unordered_map<int, int, hash<int>, equal_to<int>, node_pool_allocator<pair<const int, int>>> um;
+		for (int i = 0; i < 1000; ++i) um.insert(pair<const int, int>(i, i));
+		std::cout << "um.size() = " << um.size() << "  um[500] = " << um[500] << std::endl;
+		print_pool<node_pool_allocator<hash_table_node<pair<const int, int>>>>("插入1000个元素后");
+	}
+	print_pool<node_pool_allocator<hash_table_node<pair<const int, int>>>>("unordered_map析构后");
+	return 0;
+}
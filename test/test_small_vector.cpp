@@ -0,0 +1,81 @@
+#include "../containers_seqence/small_vector.h"
+#include "../containers_string/string.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+template<typename Vec>
+void print(const char* title, const Vec& v)
+{
+	std::cout << title << ": ";
+	for (auto it = v.begin(); it != v.end(); ++it)
+		std::cout << *it << " ";
+	std::cout << " (size " << v.size() << ", capacity " << v.capacity()
+		<< (v.is_inline() ? ", 内置空间" : ", 堆") << ")" << std::endl;
+}
+
+int main()
+{
+	std::cout << "-----------------small_vector<int, 4>----------------" << std::endl;
+	{
+		small_vector<int, 4> v;
+		print("默认构造", v);
+		for (int i = 0; i < 4; ++i) v.push_back(i);
+		print("插入4个元素", v);
+		v.push_back(4);
+		print("插入第5个元素", v);
+		v.erase(v.begin() + 1, v.end());
+		v.shrink_to_fit();
+		print("删除到只剩1个再 shrink_to_fit", v);
+		v.insert(v.begin(), 3, 9);
+		print("头部插入3个9", v);
+	}
+
+	std::cout << std::endl << "-----------------构造和赋值----------------" << std::endl;
+	{
+		small_vector<int, 4> a{ 1, 2, 3 };
+		small_vector<int, 4> b{ 1, 2, 3, 4, 5, 6 };
+		print("a", a);
+		print("b", b);
+
+		small_vector<int, 4> c(a);
+		small_vector<int, 4> d(b);
+		print("拷贝 a", c);
+		print("拷贝 b", d);
+
+		small_vector<int, 4> e(std::move(a));
+		small_vector<int, 4> f(std::move(b));
+		print("移动 a", e);
+		print("移动 b", f);
+		print("移动后的 a", a);
+		print("移动后的 b", b);
+
+		e = f;
+		print("e = f", e);
+		f = small_vector<int, 4>{ 7, 8 };
+		print("f = {7, 8}", f);
+
+		e.swap(f);
+		print("交换后 e", e);
+		print("交换后 f", f);
+	}
+
+	std::cout << std::endl << "-----------------small_vector<string, 2>----------------" << std::endl;
+	{
+		small_vector<string, 2> v;
+		v.push_back(string("one"));
+		v.push_back(string("two"));
+		print("两个元素", v);
+		v.push_back(string("three"));
+		string s("inserted");
+		v.insert(v.begin() + 1, s);
+		print("扩容到堆上", v);
+		small_vector<string, 2> w(std::move(v));
+		print("移动构造", w);
+		w.resize(1);
+		w.shrink_to_fit();
+		print("resize(1) 后 shrink_to_fit", w);
+	}
+	return 0;
+}
@@ -0,0 +1,78 @@
+#include "../containers_seqence/soa_vector.h"
+#include "../containers_string/string.h"
+#include "../algorithm/algo_numeric.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// 三个字段：编号、价格、名字
+typedef soa_vector<int, double, string> table;
+
+void print(const char* title, const table& t)
+{
+	std::cout << title << " (size " << t.size() << "):" << std::endl;
+	for (size_t i = 0; i < t.size(); ++i)
+		std::cout << "  " << t[i].get<0>() << "\t" << t[i].get<1>() << "\t" << t[i].get<2>() << std::endl;
+}
+
+int main()
+{
+	table t;
+	t.emplace_back(3, 2.5, string("pear"));
+	t.emplace_back(1, 7.25, string("apple"));
+	t.push_back(table::value_type(4, 1.0, string("fig")));
+	t.emplace_back(2, 3.75, string("kiwi"));
+	print("插入四行", t);
+
+	// 只扫描价格这一列
+	soa_span<double> price = t.column<1>();
+	std::cout << "价格之和: " << accumulate(price.begin(), price.end(), 0.0) << std::endl;
+	for (double& p : price) p *= 2;
+
+	t.sort_by<0>();
+	print("按编号排序(价格翻倍)", t);
+
+	t.sort([](table::const_reference a, table::const_reference b) { return a.get<2>() < b.get<2>(); });
+	print("按名字排序", t);
+
+	t.sort_by<1>(greater<double>());
+	print("按价格从大到小排序", t);
+
+	t[0] = table::value_type(9, 0.5, string("plum"));
+	t[1].get<2>() = string("lemon");
+	table::value_type row = t[2];
+	std::cout << "第三行: " << std::get<0>(row) << " " << std::get<2>(row) << std::endl;
+	print("修改前两行", t);
+
+	table copy(t);
+	copy.pop_back();
+	copy.resize(5);
+	print("复制后删掉一行再 resize(5)", copy);
+
+	table moved(std::move(copy));
+	std::cout << "移动后: " << moved.size() << " 行, 原来的 " << copy.size() << " 行" << std::endl;
+
+	// 扩容时参数引用容器自己的元素
+	soa_vector<long, string> self_ref;
+	self_ref.emplace_back(42L, string("a"));
+	self_ref.emplace_back(43L, string("b"));
+	self_ref.emplace_back(self_ref.data<0>()[0], self_ref.data<1>()[1]);
+	self_ref.emplace_back(self_ref.data<0>()[2], self_ref.data<1>()[2]);
+	self_ref.emplace_back(self_ref.data<0>()[1], self_ref.data<1>()[0]);
+	std::cout << "引用自身元素扩容后 (capacity " << self_ref.capacity() << "):";
+	for (size_t i = 0; i < self_ref.size(); ++i)
+		std::cout << " " << self_ref[i].get<0>() << self_ref[i].get<1>();
+	std::cout << std::endl;
+
+	// 排序大量的行
+	soa_vector<int, int> big;
+	for (int i = 0; i < 100000; ++i)
+		big.emplace_back((i * 7919) % 100003, i);
+	big.sort_by<0>();
+	bool ok = true;
+	for (size_t i = 1; i < big.size(); ++i)
+		ok = ok && big.data<0>()[i - 1] <= big.data<0>()[i] && (big[i].get<1>() * 7919) % 100003 == big[i].get<0>();
+	std::cout << "100000 行按第一列排序，其余列跟着一起移动: " << ok << "  capacity = " << big.capacity() << std::endl;
+	return 0;
+}
@@ -0,0 +1,96 @@
+#include "../containers_seqence/unrolled_list.h"
+#include "../containers_string/string.h"
+
+#include <iostream>
+
+using namespace GHYSTL;
+
+// 每个结点只放 4 个元素，方便看到分裂与合并
+typedef unrolled_list<int, 4> ulist;
+
+template<typename List>
+void print(const char* title, const List& l)
+{
+	std::cout << title << ": ";
+	for (auto it = l.begin(); it != l.end(); ++it)
+		std::cout << *it << " ";
+	std::cout << " (size " << l.size() << ", 结点 " << l.node_count() << ")" << std::endl;
+}
+
+int main()
+{
+	std::cout << "-----------------插入----------------" << std::endl;
+	ulist a;
+	for (int i = 0; i < 8; ++i)
+		a.push_back(i);
+	print("尾部插入 0~7", a);
+	a.push_front(-1);
+	print("头部插入 -1", a);
+	ulist::iterator it = a.begin();
+	for (int i = 0; i < 4; ++i) ++it;
+	it = a.insert(it, 100);
+	print("第 4 个位置插入 100(结点分裂)", a);
+	std::cout << "返回的迭代器指向: " << *it << std::endl;
+	a.insert(a.end(), 3, 7);
+	print("尾部插入 3 个 7", a);
+
+	std::cout << std::endl << "-----------------删除----------------" << std::endl;
+	it = a.erase(a.begin());
+	print("删除开头", a);
+	std::cout << "返回的迭代器指向: " << *it << std::endl;
+	ulist::iterator first = a.begin();
+	ulist::iterator last = a.begin();
+	++first;
+	for (int i = 0; i < 6; ++i) ++last;
+	it = a.erase(first, last);
+	print("删除 [1, 6)(结点合并)", a);
+	std::cout << "返回的迭代器指向: " << *it << std::endl;
+	a.remove(7);
+	print("删除所有 7", a);
+	std::cout << "反向遍历: ";
+	for (auto rit = a.rbegin(); rit != a.rend(); ++rit)
+		std::cout << *rit << " ";
+	std::cout << std::endl;
+
+	std::cout << std::endl << "-----------------splice----------------" << std::endl;
+	ulist b{ 10, 11, 12, 13, 14, 15 };
+	print("b", b);
+	ulist::iterator pos = a.begin();
+	++pos;
+	a.splice(pos, b);
+	print("b 整个接到 a 的第 1 个位置", a);
+	print("b", b);
+	ulist c{ 20, 21, 22 };
+	c.splice_node(c.end(), a, a.begin());
+	print("a 第一个结点移到 c 末尾后 c", c);
+	print("a", a);
+
+	std::cout << std::endl << "-----------------拷贝、赋值、resize----------------" << std::endl;
+	ulist d(c);
+	print("拷贝 c", d);
+	d.assign({ 1, 2 });
+	print("assign {1, 2}", d);
+	d.resize(6, 9);
+	print("resize(6, 9)", d);
+	ulist e(std::move(d));
+	print("移动构造", e);
+	print("移动后的 d", d);
+	std::cout << "e == 拷贝 e: " << (e == ulist(e)) << "  e == c: " << (e == c) << std::endl;
+	long long sum = 0;
+	e.for_each_segment([&sum](const int* first, const int* last) {
+		for (; first != last; ++first) sum += *first;
+	});
+	std::cout << "按结点求和: " << sum << std::endl;
+
+	std::cout << std::endl << "-----------------unrolled_list<string, 3>----------------" << std::endl;
+	unrolled_list<string, 3> s;
+	s.push_back(string("b"));
+	s.push_back(string("d"));
+	s.push_front(string("a"));
+	s.insert(++s.begin(), s.front()); // 插入自己的元素
+	s.insert(--s.end(), string("c"));
+	for (auto sit = s.begin(); sit != s.end(); ++sit)
+		std::cout << *sit << " ";
+	std::cout << " (size " << s.size() << ", 结点 " << s.node_count() << ")" << std::endl;
+	return 0;
+}
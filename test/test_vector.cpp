@@ -1,4 +1,5 @@
 #include <iostream>
+#include <string>
 
 #include "../containers_seqence/vector.h"
 
@@ -38,6 +39,26 @@ int main(int argc, char* argv[])
 	{
 		std::cout << *it << std::endl;
 	}
+
+	// 默认初始化和在尾部直接写入
+	vector<int> buf;
+	buf.resize_default_init(4);
+	for (size_t i = 0; i < buf.size(); ++i) buf[i] = i * 10;
+	int* p = buf.append_uninitialized(3);
+	for (int i = 0; i < 3; ++i) p[i] = 100 + i;
+	buf.commit_append(3);
+	std::cout << "size = " << buf.size() << "\t";
+	std::cout << "capacity = " << buf.capacity() << std::endl;
+	for (vector<int>::iterator it = buf.begin(); it != buf.end(); ++it)
+		std::cout << *it << " ";
+	std::cout << std::endl;
+
+	vector<std::string> strs;
+	strs.resize_default_init(2); // 非 POD 类型仍然会默认构造
+	std::string* q = strs.append_uninitialized(1);
+	new(q) std::string("appended");
+	strs.commit_append(1);
+	std::cout << strs.size() << " [" << strs[0] << "] [" << strs[2] << "]" << std::endl;
 	// system("pause");
 	return 0;
 }
\ No newline at end of file
@@ -0,0 +1,143 @@
+#include <iostream>
+#include <string>
+
+#include "../containers_seqence/vector.h"
+
+using namespace GHYSTL;
+
+// 复制(移动构造不是 noexcept，扩容时也走复制)第 budget 次时抛异常的元素
+// 记录活着的对象个数，析构一个没有构造过的对象(magic 不对)时记为一次错误
+struct Tracked
+{
+	enum { kMagic = 0x5eed };
+
+	static int live;
+	static int budget;     // 还能成功复制几次，-1 表示不限
+	static int bad_destroy;
+
+	int value;
+	int magic;
+
+	explicit Tracked(int v = 0) : value(v), magic(kMagic) { ++live; }
+
+	Tracked(const Tracked& x) : value(x.value), magic(kMagic) {
+		spend();
+		++live;
+	}
+
+	Tracked(Tracked&& x) : value(x.value), magic(kMagic) {
+		spend();
+		++live;
+	}
+
+	Tracked& operator=(const Tracked& x) {
+		spend();
+		value = x.value;
+		return *this;
+	}
+
+	Tracked& operator=(Tracked&& x) {
+		spend();
+		value = x.value;
+		return *this;
+	}
+
+	~Tracked() {
+		if (magic != kMagic)
+			++bad_destroy;
+		magic = 0;
+		--live;
+	}
+
+	static void spend() {
+		if (budget == 0)
+			throw 1;
+		if (budget > 0)
+			--budget;
+	}
+};
+
+int Tracked::live = 0;
+int Tracked::budget = -1;
+int Tracked::bad_destroy = 0;
+
+// 在第 0、1、2 ... 次复制时抛异常，每次都检查 vector 里的元素还是完整的，最后没有泄漏
+template<typename Op>
+void run(const char* name, Op op)
+{
+	int throws = 0;
+	bool intact = true;
+	for (int k = 0; k < 64; ++k) {
+		{
+			vector<Tracked> v;
+			v.reserve(10);
+			for (int i = 0; i < 8; ++i)
+				v.emplace_back(i);
+
+			Tracked::budget = k;
+			try {
+				op(v);
+			}
+			catch (int) {
+				++throws;
+			}
+			Tracked::budget = -1;
+
+			for (size_t i = 0; i < v.size(); ++i)
+				if (v[i].magic != Tracked::kMagic)
+					intact = false;
+		}
+		if (Tracked::live != 0)
+			intact = false;
+	}
+	std::cout << name << "：抛出 " << throws << " 次，元素" << (intact ? "完整" : "损坏")
+		<< "，析构未构造的对象 " << Tracked::bad_destroy << " 次，泄漏 " << Tracked::live << " 个" << std::endl;
+}
+
+int main()
+{
+	run("扩容 reserve", [](vector<Tracked>& v) { v.reserve(100); });
+	run("扩容 push_back", [](vector<Tracked>& v) {
+		v.push_back(Tracked(8));
+		v.push_back(Tracked(9));
+		v.push_back(Tracked(10));
+	});
+	run("原地插入，插入点后面元素多", [](vector<Tracked>& v) {
+		Tracked src[2] = { Tracked(20), Tracked(21) };
+		v.insert(v.begin() + 1, src, src + 2);
+	});
+	run("原地插入，插入点后面元素少", [](vector<Tracked>& v) {
+		Tracked src[2] = { Tracked(20), Tracked(21) };
+		v.insert(v.begin() + 7, src, src + 2);
+	});
+	run("原地 emplace", [](vector<Tracked>& v) { v.emplace(v.begin() + 3, 42); });
+	run("扩容插入", [](vector<Tracked>& v) {
+		Tracked src[5] = { Tracked(20), Tracked(21), Tracked(22), Tracked(23), Tracked(24) };
+		v.insert(v.begin() + 4, src, src + 5);
+	});
+	run("原地插入 n 个相同元素", [](vector<Tracked>& v) { v.insert(v.begin() + 5, 2, Tracked(30)); });
+	run("原地插入 n 个相同元素，超过插入点后面的个数", [](vector<Tracked>& v) { v.insert(v.begin() + 7, 2, Tracked(30)); });
+	run("扩容插入 n 个相同元素", [](vector<Tracked>& v) { v.insert(v.begin() + 2, 6, Tracked(30)); });
+
+	// 容量已满时 push_back / emplace_back 容器自己的元素，扩容不能先释放原来的空间
+	vector<long> w;
+	vector<std::string> ws;
+	for (long i = 0; i < 4; ++i) {
+		w.push_back(i + 100);
+		ws.push_back(std::string(20, char('a' + i)));
+	}
+	w.shrink_to_fit();
+	ws.shrink_to_fit();
+	for (int i = 0; i < 20; ++i) {
+		w.push_back(w[i % 4]);
+		w.emplace_back(w[0]);
+		ws.push_back(ws[i % 4]);
+		ws.emplace_back(ws[1]);
+	}
+	bool self_ok = true;
+	for (size_t i = 4; i < w.size(); i += 2)
+		self_ok = self_ok && w[i] == long((i - 4) / 2 % 4 + 100) && w[i + 1] == 100
+			&& ws[i] == ws[(i - 4) / 2 % 4] && ws[i + 1] == ws[1];
+	std::cout << "扩容时插入自身的元素：" << (self_ok ? "正确" : "错误") << "  size " << w.size() << " " << ws.size() << std::endl;
+	return 0;
+}